@@ -1,26 +1,122 @@
 #include "JSON.hpp"
+#include <float.h>
+#include <limits.h>
+#include <math.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <string>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define _JSON_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /*
  * String Methods
  */
-size_t _cstring_hash(const char *s)
+// Reads up to eight bytes as a little-endian word
+uint64_t _load_word(const char *s, size_t length)
 {
-    if (s == NULL)
-        return 0;
+    uint64_t w = 0;
+    for (size_t i = 0; i < length && i < 8; i++)
+    {
+        w |= (uint64_t)(unsigned char)s[i] << (8 * i);
+    }
 
-    size_t i = 0;
-    size_t x = 1000003;
+    return w;
+}
+
+// Hashes eight bytes per round. The low bits pick a table slot and the
+// high 32 bits are kept in the slot as a fingerprint.
+size_t _string_hash(const char *s, size_t length)
+{
+    uint64_t x = 1000003 ^ length;
+
+    for (; length >= 8; s += 8, length -= 8)
+    {
+        x = (x ^ _load_word(s, 8)) * 0x9E3779B97F4A7C15ull;
+        x ^= x >> 29;
+    }
+
+    x = (x ^ _load_word(s, length)) * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ull;
+    x ^= x >> 32;
+
+    return (size_t)x;
+}
+
+// Smallest power of two that keeps the load factor at or below one half
+size_t _table_capacity(size_t size)
+{
+    size_t capacity = 0;
+    if (size != 0)
+    {
+        for (capacity = 2; capacity < size * 2; capacity *= 2)
+            ;
+    }
+
+    return capacity;
+}
+
+// Parses a canonical array index, as produced by iterating over an array
+bool _parse_index(const char *s, size_t length, size_t *index)
+{
+    if (length == 0 || (s[0] == '0' && length != 1))
+    {
+        return false;
+    }
 
-    for (const char *p = s; *p; p++, i++)
+    size_t i = 0;
+    for (size_t k = 0; k < length; k++)
     {
-        x = (1000003 * x) ^ *p;
+        if (s[k] < '0' || s[k] > '9' || i > ((size_t)-1 - 9) / 10)
+        {
+            return false;
+        }
+
+        i = i * 10 + (s[k] - '0');
     }
 
-    return x ^ i;
+    *index = i;
+    return true;
+}
+
+void _format_index(size_t index, std::string *out)
+{
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    do
+    {
+        *--p = '0' + index % 10;
+        index /= 10;
+    } while (index != 0);
+
+    out->assign(p, digits + sizeof(digits) - p);
+}
+
+const char *_string_data(const JSON::_String &s)
+{
+    return s._value == NULL ? s._data : s._value->c_str();
+}
+
+size_t _string_length(const JSON::_String &s)
+{
+    return s._value == NULL ? s._length : s._value->length();
 }
 
 const char *_json_type_to_cstring(JSON::Type type)
@@ -42,860 +138,8709 @@ const char *_json_type_to_cstring(JSON::Type type)
     }
 }
 
-std::string _dump_string(std::string &src)
+/*
+ * Scanning kernels
+ *
+ * The parsing kernels stop at the first interesting byte, at a NUL or at the
+ * end of the input, whichever comes first. They only issue aligned loads,
+ * and only for blocks that start before the end, so a load never crosses
+ * into a page that the input does not touch. Bytes before the cursor and
+ * at or past the end are masked off. NUL-terminated input is passed with
+ * _no_end. The escaping kernel works on length-delimited strings.
+ */
+const char *const _no_end = (const char *)~(uintptr_t)0;
+
+bool _is_whitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Sets the bits of a block mask that fall at or past the end of the input
+uint32_t _past_end(const char *p, const char *end, unsigned int width)
+{
+    uintptr_t remaining = (uintptr_t)end - (uintptr_t)p;
+    return remaining < width ? ~(uint32_t)0 << remaining : 0;
+}
+
+const char *_scan_string_scalar(const char *s, const char *end)
 {
-    std::vector<std::string> codepoints;
+    for (; s < end && *s != '"' && *s != '\\' && (unsigned char)*s >= ' '; s++)
+        ;
 
-    for (auto iter = src.rbegin(); iter < src.rend(); ++iter)
+    return s;
+}
+
+const char *_scan_whitespace_scalar(const char *s, const char *end, int *line)
+{
+    for (; s < end && _is_whitespace(*s); s++)
     {
-        if (*iter == 0x7F)
-        {
-            codepoints.push_back("\\u007F");
-        }
-        else if ((unsigned char)*iter >= (unsigned char)' ')
-        {
-            char buf[] = {*iter, '\0'};
-            codepoints.push_back(buf);
-        }
-        else
+        if (*s == '\n')
         {
-            switch (*iter)
-            {
-            case '"':
-                codepoints.push_back("\\\"");
-                break;
-            case '\\':
-                codepoints.push_back("\\\\");
-                break;
-            case '/':
-                codepoints.push_back("\\/");
-                break;
-            case '\b':
-                codepoints.push_back("\\b");
-                break;
-            case '\f':
-                codepoints.push_back("\\f");
-                break;
-            case '\n':
-                codepoints.push_back("\\n");
-                break;
-            case '\r':
-                codepoints.push_back("\\r");
-                break;
-            case '\t':
-                codepoints.push_back("\\t");
-                break;
-            default:
-                throw JSON::UnknownInternalException();
-            }
+            *line += 1;
         }
     }
 
-    std::string repr = "\"";
+    return s;
+}
+
+bool _needs_escape(char c)
+{
+    return c == '"' || c == '\\' || (unsigned char)c < ' ' || c == 0x7F;
+}
 
-    for (auto iter = codepoints.rbegin(); iter < codepoints.rend(); ++iter)
-    {
-        repr += *iter;
-    }
+const char *_scan_escape_scalar(const char *s, const char *end)
+{
+    for (; s < end && !_needs_escape(*s); s++)
+        ;
 
-    repr += "\"";
-    return repr;
+    return s;
 }
 
-/*
- * Parsing of primitive types
- */
-const char *__consume_phrase(const char *s, const char *phrase, int line)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define _JSON_X86_KERNELS
+#include <immintrin.h>
+
+__attribute__((target("sse2"), no_sanitize_address))
+const char *_scan_string_sse2(const char *s, const char *end)
 {
-    for (const char *p = phrase; *p; p++, s++)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+    unsigned int skip = (unsigned int)(s - p);
+
+    for (; p < end; p += 16, skip = 0)
     {
-        if (*p != *s)
+        __m128i x = _mm_load_si128((const __m128i *)p);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+                                 _mm_cmpeq_epi8(_mm_max_epu8(x, control), control));
+
+        unsigned int mask = ((unsigned int)_mm_movemask_epi8(m) | _past_end(p, end, 16)) >> skip << skip;
+        if (mask != 0)
         {
-            throw JSON::DecodeException(line);
+            return p + __builtin_ctz(mask);
         }
     }
 
-    return s;
+    return end;
 }
-#define _CONSUME_NULL(s, line) (__consume_phrase(s, "null", line))
-#define _CONSUME_TRUE(s, line) (__consume_phrase(s, "true", line))
-#define _CONSUME_FALSE(s, line) (__consume_phrase(s, "false", line))
 
-const char *_consume_number(const char *s, double *x, int line)
+__attribute__((target("sse2"), no_sanitize_address))
+const char *_scan_whitespace_sse2(const char *s, const char *end, int *line)
 {
-    std::string buffer;
-    if (*s == '-')
-    {
-        buffer += *(s++);
-    }
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
 
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+    unsigned int before = (1u << (s - p)) - 1;
 
-    if ((s[0] == '-' && !(s[1] >= '0' && s[1] <= '9')))
+    for (; p < end; p += 16, before = 0)
     {
-        throw JSON::DecodeException(line);
+        __m128i x = _mm_load_si128((const __m128i *)p);
+        __m128i n = _mm_cmpeq_epi8(x, lf);
+        __m128i w = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, tab)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(x, cr), n));
+
+        unsigned int newlines = (unsigned int)_mm_movemask_epi8(n) & ~before;
+        unsigned int stop = (~((unsigned int)_mm_movemask_epi8(w) | before) & 0xFFFF) | (_past_end(p, end, 16) & ~before);
+        if (stop != 0)
+        {
+            unsigned int i = __builtin_ctz(stop);
+            *line += __builtin_popcount(newlines & ((1u << i) - 1));
+            return p + i;
+        }
+
+        *line += __builtin_popcount(newlines);
     }
 
-    sscanf(s, "%lf", x);
+    return end;
+}
 
-    bool dot = false;
-    bool eee = false;
-    for (s = *s == '-' ? s + 1 : s; true; s++)
-    {
-        if (*s >= '0' && *s <= '9')
-        {
-            continue;
-        }
-        if (!eee && *s == 'e')
-        {
-            eee = true;
-            dot = true;
+__attribute__((target("avx2"), no_sanitize_address))
+const char *_scan_string_avx2(const char *s, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
 
-            if (s[1] == '-')
-            {
-                s++;
-            }
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    unsigned int skip = (unsigned int)(s - p);
 
-            continue;
-        }
-        if (!dot && *s == '.')
+    for (; p < end; p += 32, skip = 0)
+    {
+        __m256i x = _mm256_load_si256((const __m256i *)p);
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash)),
+                                    _mm256_cmpeq_epi8(_mm256_max_epu8(x, control), control));
+
+        unsigned int mask = ((unsigned int)_mm256_movemask_epi8(m) | _past_end(p, end, 32)) >> skip << skip;
+        if (mask != 0)
         {
-            dot = true;
-            continue;
+            return p + __builtin_ctz(mask);
         }
-        break;
     }
 
-    return s;
+    return end;
 }
 
-const char *_consume_string(const char *s, std::string **r, int line)
+__attribute__((target("avx2"), no_sanitize_address))
+const char *_scan_whitespace_avx2(const char *s, const char *end, int *line)
 {
-    std::string *p = *r = new std::string();
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
 
-    for (s++;; s++)
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    unsigned int before = (unsigned int)((1ull << (s - p)) - 1);
+
+    for (; p < end; p += 32, before = 0)
     {
-        if (*s >= 0 && *s < ' ')
+        __m256i x = _mm256_load_si256((const __m256i *)p);
+        __m256i n = _mm256_cmpeq_epi8(x, lf);
+        __m256i w = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, space), _mm256_cmpeq_epi8(x, tab)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(x, cr), n));
+
+        unsigned int newlines = (unsigned int)_mm256_movemask_epi8(n) & ~before;
+        unsigned int stop = ~((unsigned int)_mm256_movemask_epi8(w) | before) | (_past_end(p, end, 32) & ~before);
+        if (stop != 0)
         {
-            throw JSON::InvalidControlCharacterException();
+            unsigned int i = __builtin_ctz(stop);
+            *line += __builtin_popcount(newlines & (unsigned int)((1ull << i) - 1));
+            return p + i;
         }
 
-        if (*s == '\\')
-        {
-            switch (*++s)
-            {
-            case '"':
-            case '\\':
-            case '/':
-                *p += *(s++);
-                break;
-            case 'b':
-                *p += '\b';
-                s++;
-                break;
-            case 'f':
-                *p += '\f';
-                s++;
-                break;
-            case 'n':
-                *p += '\n';
-                s++;
-                break;
-            case 'r':
-                *p += '\r';
-                s++;
-                break;
-            case 't':
-                *p += '\t';
-                s++;
-                break;
-            case 'u':
-            {
-                char u[5] = {0};
+        *line += __builtin_popcount(newlines);
+    }
 
-                s++;
-                for (int i = 0; i < 4; i++, s++)
-                {
-                    if ((*s >= '0' && *s <= '9') ||
-                        (*s >= 'A' && *s <= 'F') ||
-                        (*s >= 'a' && *s <= 'f'))
-                    {
-                        u[i] = *s;
-                    }
-                    else
-                    {
-                        delete p;
-                        throw JSON::DecodeException(line);
-                    }
-                }
+    return end;
+}
 
-                unsigned int t;
-                sscanf(u, "%x", &t);
+__attribute__((target("sse2")))
+const char *_scan_escape_sse2(const char *s, const char *end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    const __m128i del = _mm_set1_epi8(0x7F);
 
-                if (t < 0x20)
-                {
-                    throw JSON::InvalidControlCharacterException();
-                }
-                if (t <= 0xFF)
-                {
-                    *p += (char)(t);
-                }
-                else
-                {
-                    *p += (char)(t >> 8);
-                    *p += (char)(t & 0xFF);
-                }
-            }
-            break;
-            default:
-                delete p;
-                throw JSON::DecodeException(line);
-            }
-        }
+    for (; end - s >= 16; s += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)s);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(x, control), control), _mm_cmpeq_epi8(x, del)));
 
-        switch (*s)
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(m);
+        if (mask != 0)
         {
-        case '\0':
-        case '\b':
-        case '\f':
-        case '\n':
-        case '\r':
-            delete p;
-            throw JSON::DecodeException(line);
-        case '"':
-            goto end_of_string;
-        default:
-            *p += *s;
-            break;
+            return s + __builtin_ctz(mask);
         }
     }
 
-end_of_string:
-    if (*s != '"')
-    {
-        delete p;
-        throw JSON::DecodeException(line);
-    }
-
-    return s + 1;
+    return _scan_escape_scalar(s, end);
 }
 
-const char *_consume_whitespace(const char *s, int *line)
+__attribute__((target("avx2")))
+const char *_scan_escape_avx2(const char *s, const char *end)
 {
-    for (; isspace(*s); s++)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    const __m256i del = _mm256_set1_epi8(0x7F);
+
+    for (; end - s >= 32; s += 32)
     {
-        if (*s == '\n')
+        __m256i x = _mm256_loadu_si256((const __m256i *)s);
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(x, control), control), _mm256_cmpeq_epi8(x, del)));
+
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(m);
+        if (mask != 0)
         {
-            *line += 1;
+            return s + __builtin_ctz(mask);
         }
     }
 
-    return s;
+    return _scan_escape_sse2(s, end);
 }
+#endif
 
-/*
- * _Node
- */
-JSON::_Node::_Node()
+struct _Kernels
 {
-    _key = NULL;
-    _type = JSON::JSON_NULL;
-    _next = NULL;
-}
+    const char *(*scan_string)(const char *, const char *);
+    const char *(*scan_whitespace)(const char *, const char *, int *);
+    const char *(*scan_escape)(const char *, const char *);
+};
 
-JSON::_Node::_Node(const _Node &other)
+_Kernels _select_kernels()
 {
-    _type = other._type;
-    
-    if (other._key == NULL)
+    _Kernels k = {_scan_string_scalar, _scan_whitespace_scalar, _scan_escape_scalar};
+
+#ifdef _JSON_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
     {
-        _key = NULL;
+        k.scan_string = _scan_string_avx2;
+        k.scan_whitespace = _scan_whitespace_avx2;
+        k.scan_escape = _scan_escape_avx2;
     }
-    else
+    else if (__builtin_cpu_supports("sse2"))
     {
-        _key = new std::string(*other._key);
+        k.scan_string = _scan_string_sse2;
+        k.scan_whitespace = _scan_whitespace_sse2;
+        k.scan_escape = _scan_escape_sse2;
     }
+#endif
 
-    switch (other._type)
-    {
-    case JSON::OBJECT:
-        _object = new JSON::Object(*other._object);
-        break;
-    case JSON::STRING:
-        _string = new std::string(*other._string);
-        break;
-    case JSON::NUMBER:
-        _number = other._number;
-        break;
-    case JSON::BOOLEAN:
-        _boolean = other._boolean;
-        break;
-    default:
-        break;
-    }
+    return k;
 }
 
-JSON::_Node::~_Node()
+const _Kernels &_kernels()
 {
-    if (_key != NULL)
-    {
-        delete _key;
-    }
+    static const _Kernels k = _select_kernels();
+    return k;
+}
+
+void _dump_string(const char *src, size_t length, std::string *out)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    const char *end = src + length;
+
+    *out += '"';
 
-    switch (_type)
+    for (;;)
     {
-    case JSON::OBJECT:
-        if (_object != NULL)
+        // Copy everything up to the next byte that needs escaping
+        const char *run = _kernels().scan_escape(src, end);
+        out->append(src, run - src);
+
+        if (run == end)
         {
-            delete _object;
+            break;
         }
-        break;
-    case JSON::STRING:
-        if (_string != NULL)
+
+        switch (*run)
         {
-            delete _string;
+        case '"':
+            out->append("\\\"", 2);
+            break;
+        case '\\':
+            out->append("\\\\", 2);
+            break;
+        case '\b':
+            out->append("\\b", 2);
+            break;
+        case '\f':
+            out->append("\\f", 2);
+            break;
+        case '\n':
+            out->append("\\n", 2);
+            break;
+        case '\r':
+            out->append("\\r", 2);
+            break;
+        case '\t':
+            out->append("\\t", 2);
+            break;
+        default:
+        {
+            char u[] = {'\\', 'u', '0', '0', hex[(*run >> 4) & 0xF], hex[*run & 0xF]};
+            out->append(u, sizeof(u));
+            break;
         }
-        break;
-    default:
-        break;
+        }
+
+        src = run + 1;
     }
+
+    *out += '"';
 }
 
 /*
- * Object
+ * Decimal to binary conversion
+ *
+ * Numbers with at most 19 significant digits are converted with the
+ * Eisel-Lemire algorithm, or with a single exact floating-point operation
+ * when both the mantissa and the power of ten are exactly representable.
+ * Longer numbers that the truncated mantissa cannot decide are converted
+ * exactly with big integer arithmetic.
  */
-JSON::Object::Object(const char *s)
+const double _exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Truncated 128-bit approximations of 5^q for q in [-342, 308]
+const uint64_t _powers_of_five_128[] = {
+    0xeef453d6923bd65a, 0x113faa2906a13b3f, 0x9558b4661b6565f8, 0x4ac7ca59a424c507,
+    0xbaaee17fa23ebf76, 0x5d79bcf00d2df649, 0xe95a99df8ace6f53, 0xf4d82c2c107973dc,
+    0x91d8a02bb6c10594, 0x79071b9b8a4be869, 0xb64ec836a47146f9, 0x9748e2826cdee284,
+    0xe3e27a444d8d98b7, 0xfd1b1b2308169b25, 0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7,
+    0xb208ef855c969f4f, 0xbdbd2d335e51a935, 0xde8b2b66b3bc4723, 0xad2c788035e61382,
+    0x8b16fb203055ac76, 0x4c3bcb5021afcc31, 0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d,
+    0xd953e8624b85dd78, 0xd71d6dad34a2af0d, 0x87d4713d6f33aa6b, 0x8672648c40e5ad68,
+    0xa9c98d8ccb009506, 0x680efdaf511f18c2, 0xd43bf0effdc0ba48, 0x0212bd1b2566def2,
+    0x84a57695fe98746d, 0x014bb630f7604b57, 0xa5ced43b7e3e9188, 0x419ea3bd35385e2d,
+    0xcf42894a5dce35ea, 0x52064cac828675b9, 0x818995ce7aa0e1b2, 0x7343efebd1940993,
+    0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8, 0xca66fa129f9b60a6, 0xd41a26e077774ef6,
+    0xfd00b897478238d0, 0x8920b098955522b4, 0x9e20735e8cb16382, 0x55b46e5f5d5535b0,
+    0xc5a890362fddbc62, 0xeb2189f734aa831d, 0xf712b443bbd52b7b, 0xa5e9ec7501d523e4,
+    0x9a6bb0aa55653b2d, 0x47b233c92125366e, 0xc1069cd4eabe89f8, 0x999ec0bb696e840a,
+    0xf148440a256e2c76, 0xc00670ea43ca250d, 0x96cd2a865764dbca, 0x380406926a5e5728,
+    0xbc807527ed3e12bc, 0xc605083704f5ecf2, 0xeba09271e88d976b, 0xf7864a44c633682e,
+    0x93445b8731587ea3, 0x7ab3ee6afbe0211d, 0xb8157268fdae9e4c, 0x5960ea05bad82964,
+    0xe61acf033d1a45df, 0x6fb92487298e33bd, 0x8fd0c16206306bab, 0xa5d3b6d479f8e056,
+    0xb3c4f1ba87bc8696, 0x8f48a4899877186c, 0xe0b62e2929aba83c, 0x331acdabfe94de87,
+    0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14, 0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9,
+    0xdb71e91432b1a24a, 0xc9e82cd9f69d6150, 0x892731ac9faf056e, 0xbe311c083a225cd2,
+    0xab70fe17c79ac6ca, 0x6dbd630a48aaf406, 0xd64d3d9db981787d, 0x092cbbccdad5b108,
+    0x85f0468293f0eb4e, 0x25bbf56008c58ea5, 0xa76c582338ed2621, 0xaf2af2b80af6f24e,
+    0xd1476e2c07286faa, 0x1af5af660db4aee1, 0x82cca4db847945ca, 0x50d98d9fc890ed4d,
+    0xa37fce126597973c, 0xe50ff107bab528a0, 0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8,
+    0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a, 0x9faacf3df73609b1, 0x77b191618c54e9ac,
+    0xc795830d75038c1d, 0xd59df5b9ef6a2417, 0xf97ae3d0d2446f25, 0x4b0573286b44ad1d,
+    0x9becce62836ac577, 0x4ee367f9430aec32, 0xc2e801fb244576d5, 0x229c41f793cda73f,
+    0xf3a20279ed56d48a, 0x6b43527578c1110f, 0x9845418c345644d6, 0x830a13896b78aaa9,
+    0xbe5691ef416bd60c, 0x23cc986bc656d553, 0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8,
+    0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9, 0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53,
+    0xe858ad248f5c22c9, 0xd1b3400f8f9cff68, 0x91376c36d99995be, 0x23100809b9c21fa1,
+    0xb58547448ffffb2d, 0xabd40a0c2832a78a, 0xe2e69915b3fff9f9, 0x16c90c8f323f516c,
+    0x8dd01fad907ffc3b, 0xae3da7d97f6792e3, 0xb1442798f49ffb4a, 0x99cd11cfdf41779c,
+    0xdd95317f31c7fa1d, 0x40405643d711d583, 0x8a7d3eef7f1cfc52, 0x482835ea666b2572,
+    0xad1c8eab5ee43b66, 0xda3243650005eecf, 0xd863b256369d4a40, 0x90bed43e40076a82,
+    0x873e4f75e2224e68, 0x5a7744a6e804a291, 0xa90de3535aaae202, 0x711515d0a205cb36,
+    0xd3515c2831559a83, 0x0d5a5b44ca873e03, 0x8412d9991ed58091, 0xe858790afe9486c2,
+    0xa5178fff668ae0b6, 0x626e974dbe39a872, 0xce5d73ff402d98e3, 0xfb0a3d212dc8128f,
+    0x80fa687f881c7f8e, 0x7ce66634bc9d0b99, 0xa139029f6a239f72, 0x1c1fffc1ebc44e80,
+    0xc987434744ac874e, 0xa327ffb266b56220, 0xfbe9141915d7a922, 0x4bf1ff9f0062baa8,
+    0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9, 0xc4ce17b399107c22, 0xcb550fb4384d21d3,
+    0xf6019da07f549b2b, 0x7e2a53a146606a48, 0x99c102844f94e0fb, 0x2eda7444cbfc426d,
+    0xc0314325637a1939, 0xfa911155fefb5308, 0xf03d93eebc589f88, 0x793555ab7eba27ca,
+    0x96267c7535b763b5, 0x4bc1558b2f3458de, 0xbbb01b9283253ca2, 0x9eb1aaedfb016f16,
+    0xea9c227723ee8bcb, 0x465e15a979c1cadc, 0x92a1958a7675175f, 0x0bfacd89ec191ec9,
+    0xb749faed14125d36, 0xcef980ec671f667b, 0xe51c79a85916f484, 0x82b7e12780e7401a,
+    0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810, 0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15,
+    0xdfbdcece67006ac9, 0x67a791e093e1d49a, 0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0,
+    0xaecc49914078536d, 0x58fae9f773886e18, 0xda7f5bf590966848, 0xaf39a475506a899e,
+    0x888f99797a5e012d, 0x6d8406c952429603, 0xaab37fd7d8f58178, 0xc8e5087ba6d33b83,
+    0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64, 0x855c3be0a17fcd26, 0x5cf2eea09a55067f,
+    0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e, 0xd0601d8efc57b08b, 0xf13b94daf124da26,
+    0x823c12795db6ce57, 0x76c53d08d6b70858, 0xa2cb1717b52481ed, 0x54768c4b0c64ca6e,
+    0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09, 0xfe5d54150b090b02, 0xd3f93b35435d7c4c,
+    0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf, 0xc6b8e9b0709f109a, 0x359ab6419ca1091b,
+    0xf867241c8cc6d4c0, 0xc30163d203c94b62, 0x9b407691d7fc44f8, 0x79e0de63425dcf1d,
+    0xc21094364dfb5636, 0x985915fc12f542e4, 0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d,
+    0x979cf3ca6cec5b5a, 0xa705992ceecf9c42, 0xbd8430bd08277231, 0x50c6ff782a838353,
+    0xece53cec4a314ebd, 0xa4f8bf5635246428, 0x940f4613ae5ed136, 0x871b7795e136be99,
+    0xb913179899f68584, 0x28e2557b59846e3f, 0xe757dd7ec07426e5, 0x331aeada2fe589cf,
+    0x9096ea6f3848984f, 0x3ff0d2c85def7621, 0xb4bca50b065abe63, 0x0fed077a756b53a9,
+    0xe1ebce4dc7f16dfb, 0xd3e8495912c62894, 0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c,
+    0xb080392cc4349dec, 0xbd8d794d96aacfb3, 0xdca04777f541c567, 0xecf0d7a0fc5583a0,
+    0x89e42caaf9491b60, 0xf41686c49db57244, 0xac5d37d5b79b6239, 0x311c2875c522ced5,
+    0xd77485cb25823ac7, 0x7d633293366b828b, 0x86a8d39ef77164bc, 0xae5dff9c02033197,
+    0xa8530886b54dbdeb, 0xd9f57f830283fdfc, 0xd267caa862a12d66, 0xd072df63c324fd7b,
+    0x8380dea93da4bc60, 0x4247cb9e59f71e6d, 0xa46116538d0deb78, 0x52d9be85f074e608,
+    0xcd795be870516656, 0x67902e276c921f8b, 0x806bd9714632dff6, 0x00ba1cd8a3db53b6,
+    0xa086cfcd97bf97f3, 0x80e8a40eccd228a4, 0xc8a883c0fdaf7df0, 0x6122cd128006b2cd,
+    0xfad2a4b13d1b5d6c, 0x796b805720085f81, 0x9cc3a6eec6311a63, 0xcbe3303674053bb0,
+    0xc3f490aa77bd60fc, 0xbedbfc4411068a9c, 0xf4f1b4d515acb93b, 0xee92fb5515482d44,
+    0x991711052d8bf3c5, 0x751bdd152d4d1c4a, 0xbf5cd54678eef0b6, 0xd262d45a78a0635d,
+    0xef340a98172aace4, 0x86fb897116c87c34, 0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0,
+    0xbae0a846d2195712, 0x8974836059cca109, 0xe998d258869facd7, 0x2bd1a438703fc94b,
+    0x91ff83775423cc06, 0x7b6306a34627ddcf, 0xb67f6455292cbf08, 0x1a3bc84c17b1d542,
+    0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93, 0x8e938662882af53e, 0x547eb47b7282ee9c,
+    0xb23867fb2a35b28d, 0xe99e619a4f23aa43, 0xdec681f9f4c31f31, 0x6405fa00e2ec94d4,
+    0x8b3c113c38f9f37e, 0xde83bc408dd3dd04, 0xae0b158b4738705e, 0x9624ab50b148d445,
+    0xd98ddaee19068c76, 0x3badd624dd9b0957, 0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6,
+    0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c, 0xd47487cc8470652b, 0x7647c3200069671f,
+    0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073, 0xa5fb0a17c777cf09, 0xf468107100525890,
+    0xcf79cc9db955c2cc, 0x7182148d4066eeb4, 0x81ac1fe293d599bf, 0xc6f14cd848405530,
+    0xa21727db38cb002f, 0xb8ada00e5a506a7c, 0xca9cf1d206fdc03b, 0xa6d90811f0e4851c,
+    0xfd442e4688bd304a, 0x908f4a166d1da663, 0x9e4a9cec15763e2e, 0x9a598e4e043287fe,
+    0xc5dd44271ad3cdba, 0x40eff1e1853f29fd, 0xf7549530e188c128, 0xd12bee59e68ef47c,
+    0x9a94dd3e8cf578b9, 0x82bb74f8301958ce, 0xc13a148e3032d6e7, 0xe36a52363c1faf01,
+    0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1, 0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9,
+    0xbcb2b812db11a5de, 0x7415d448f6b6f0e7, 0xebdf661791d60f56, 0x111b495b3464ad21,
+    0x936b9fcebb25c995, 0xcab10dd900beec34, 0xb84687c269ef3bfb, 0x3d5d514f40eea742,
+    0xe65829b3046b0afa, 0x0cb4a5a3112a5112, 0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab,
+    0xb3f4e093db73a093, 0x59ed216765690f56, 0xe0f218b8d25088b8, 0x306869c13ec3532c,
+    0x8c974f7383725573, 0x1e414218c73a13fb, 0xafbd2350644eeacf, 0xe5d1929ef90898fa,
+    0xdbac6c247d62a583, 0xdf45f746b74abf39, 0x894bc396ce5da772, 0x6b8bba8c328eb783,
+    0xab9eb47c81f5114f, 0x066ea92f3f326564, 0xd686619ba27255a2, 0xc80a537b0efefebd,
+    0x8613fd0145877585, 0xbd06742ce95f5f36, 0xa798fc4196e952e7, 0x2c48113823b73704,
+    0xd17f3b51fca3a7a0, 0xf75a15862ca504c5, 0x82ef85133de648c4, 0x9a984d73dbe722fb,
+    0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba, 0xcc963fee10b7d1b3, 0x318df905079926a8,
+    0xffbbcfe994e5c61f, 0xfdf17746497f7052, 0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633,
+    0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0, 0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0,
+    0x9c1661a651213e2d, 0x06bea10ca65c084e, 0xc31bfa0fe5698db8, 0x486e494fcff30a62,
+    0xf3e2f893dec3f126, 0x5a89dba3c3efccfa, 0x986ddb5c6b3a76b7, 0xf89629465a75e01c,
+    0xbe89523386091465, 0xf6bbb397f1135823, 0xee2ba6c0678b597f, 0x746aa07ded582e2c,
+    0x94db483840b717ef, 0xa8c2a44eb4571cdc, 0xba121a4650e4ddeb, 0x92f34d62616ce413,
+    0xe896a0d7e51e1566, 0x77b020baf9c81d17, 0x915e2486ef32cd60, 0x0ace1474dc1d122e,
+    0xb5b5ada8aaff80b8, 0x0d819992132456ba, 0xe3231912d5bf60e6, 0x10e1fff697ed6c69,
+    0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1, 0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2,
+    0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde, 0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b,
+    0xad4ab7112eb3929d, 0x86c16c98d2c953c6, 0xd89d64d57a607744, 0xe871c7bf077ba8b7,
+    0x87625f056c7c4a8b, 0x11471cd764ad4972, 0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf,
+    0xd389b47879823479, 0x4aff1d108d4ec2c3, 0x843610cb4bf160cb, 0xcedf722a585139ba,
+    0xa54394fe1eedb8fe, 0xc2974eb4ee658828, 0xce947a3da6a9273e, 0x733d226229feea32,
+    0x811ccc668829b887, 0x0806357d5a3f525f, 0xa163ff802a3426a8, 0xca07c2dcb0cf26f7,
+    0xc9bcff6034c13052, 0xfc89b393dd02f0b5, 0xfc2c3f3841f17c67, 0xbbac2078d443ace2,
+    0x9d9ba7832936edc0, 0xd54b944b84aa4c0d, 0xc5029163f384a931, 0x0a9e795e65d4df11,
+    0xf64335bcf065d37d, 0x4d4617b5ff4a16d5, 0x99ea0196163fa42e, 0x504bced1bf8e4e45,
+    0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6, 0xf07da27a82c37088, 0x5d767327bb4e5a4c,
+    0x964e858c91ba2655, 0x3a6a07f8d510f86f, 0xbbe226efb628afea, 0x890489f70a55368b,
+    0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e, 0x92c8ae6b464fc96f, 0x3b0b8bc90012929d,
+    0xb77ada0617e3bbcb, 0x09ce6ebb40173744, 0xe55990879ddcaabd, 0xcc420a6a101d0515,
+    0x8f57fa54c2a9eab6, 0x9fa946824a12232d, 0xb32df8e9f3546564, 0x47939822dc96abf9,
+    0xdff9772470297ebd, 0x59787e2b93bc56f7, 0x8bfbea76c619ef36, 0x57eb4edb3c55b65a,
+    0xaefae51477a06b03, 0xede622920b6b23f1, 0xdab99e59958885c4, 0xe95fab368e45eced,
+    0x88b402f7fd75539b, 0x11dbcb0218ebb414, 0xaae103b5fcd2a881, 0xd652bdc29f26a119,
+    0xd59944a37c0752a2, 0x4be76d3346f0495f, 0x857fcae62d8493a5, 0x6f70a4400c562ddb,
+    0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952, 0xd097ad07a71f26b2, 0x7e2000a41346a7a7,
+    0x825ecc24c873782f, 0x8ed400668c0c28c8, 0xa2f67f2dfa90563b, 0x728900802f0f32fa,
+    0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9, 0xfea126b7d78186bc, 0xe2f610c84987bfa8,
+    0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9, 0xc6ede63fa05d3143, 0x91503d1c79720dbb,
+    0xf8a95fcf88747d94, 0x75a44c6397ce912a, 0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba,
+    0xc24452da229b021b, 0xfbe85badce996168, 0xf2d56790ab41c2a2, 0xfae27299423fb9c3,
+    0x97c560ba6b0919a5, 0xdccd879fc967d41a, 0xbdb6b8e905cb600f, 0x5400e987bbc1c920,
+    0xed246723473e3813, 0x290123e9aab23b68, 0x9436c0760c86e30b, 0xf9a0b6720aaf6521,
+    0xb94470938fa89bce, 0xf808e40e8d5b3e69, 0xe7958cb87392c2c2, 0xb60b1d1230b20e04,
+    0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2, 0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3,
+    0xe2280b6c20dd5232, 0x25c6da63c38de1b0, 0x8d590723948a535f, 0x579c487e5a38ad0e,
+    0xb0af48ec79ace837, 0x2d835a9df0c6d851, 0xdcdb1b2798182244, 0xf8e431456cf88e65,
+    0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff, 0xac8b2d36eed2dac5, 0xe272467e3d222f3f,
+    0xd7adf884aa879177, 0x5b0ed81dcc6abb0f, 0x86ccbb52ea94baea, 0x98e947129fc2b4e9,
+    0xa87fea27a539e9a5, 0x3f2398d747b36224, 0xd29fe4b18e88640e, 0x8eec7f0d19a03aad,
+    0x83a3eeeef9153e89, 0x1953cf68300424ac, 0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7,
+    0xcdb02555653131b6, 0x3792f412cb06794d, 0x808e17555f3ebf11, 0xe2bbd88bbee40bd0,
+    0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4, 0xc8de047564d20a8b, 0xf245825a5a445275,
+    0xfb158592be068d2e, 0xeed6e2f0f0d56712, 0x9ced737bb6c4183d, 0x55464dd69685606b,
+    0xc428d05aa4751e4c, 0xaa97e14c3c26b886, 0xf53304714d9265df, 0xd53dd99f4b3066a8,
+    0x993fe2c6d07b7fab, 0xe546a8038efe4029, 0xbf8fdb78849a5f96, 0xde98520472bdd033,
+    0xef73d256a5c0f77c, 0x963e66858f6d4440, 0x95a8637627989aad, 0xdde7001379a44aa8,
+    0xbb127c53b17ec159, 0x5560c018580d5d52, 0xe9d71b689dde71af, 0xaab8f01e6e10b4a6,
+    0x9226712162ab070d, 0xcab3961304ca70e8, 0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22,
+    0xe45c10c42a2b3b05, 0x8cb89a7db77c506a, 0x8eb98a7a9a5b04e3, 0x77f3608e92adb242,
+    0xb267ed1940f1c61c, 0x55f038b237591ed3, 0xdf01e85f912e37a3, 0x6b6c46dec52f6688,
+    0x8b61313bbabce2c6, 0x2323ac4b3b3da015, 0xae397d8aa96c1b77, 0xabec975e0a0d081a,
+    0xd9c7dced53c72255, 0x96e7bd358c904a21, 0x881cea14545c7575, 0x7e50d64177da2e54,
+    0xaa242499697392d2, 0xdde50bd1d5d0b9e9, 0xd4ad2dbfc3d07787, 0x955e4ec64b44e864,
+    0x84ec3c97da624ab4, 0xbd5af13bef0b113e, 0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e,
+    0xcfb11ead453994ba, 0x67de18eda5814af2, 0x81ceb32c4b43fcf4, 0x80eacf948770ced7,
+    0xa2425ff75e14fc31, 0xa1258379a94d028d, 0xcad2f7f5359a3b3e, 0x096ee45813a04330,
+    0xfd87b5f28300ca0d, 0x8bca9d6e188853fc, 0x9e74d1b791e07e48, 0x775ea264cf55347e,
+    0xc612062576589dda, 0x95364afe032a819e, 0xf79687aed3eec551, 0x3a83ddbd83f52205,
+    0x9abe14cd44753b52, 0xc4926a9672793543, 0xc16d9a0095928a27, 0x75b7053c0f178294,
+    0xf1c90080baf72cb1, 0x5324c68b12dd6339, 0x971da05074da7bee, 0xd3f6fc16ebca5e04,
+    0xbce5086492111aea, 0x88f4bb1ca6bcf585, 0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6,
+    0x9392ee8e921d5d07, 0x3aff322e62439fd0, 0xb877aa3236a4b449, 0x09befeb9fad487c3,
+    0xe69594bec44de15b, 0x4c2ebe687989a9b4, 0x901d7cf73ab0acd9, 0x0f9d37014bf60a11,
+    0xb424dc35095cd80f, 0x538484c19ef38c95, 0xe12e13424bb40e13, 0x2865a5f206b06fba,
+    0x8cbccc096f5088cb, 0xf93f87b7442e45d4, 0xafebff0bcb24aafe, 0xf78f69a51539d749,
+    0xdbe6fecebdedd5be, 0xb573440e5a884d1c, 0x89705f4136b4a597, 0x31680a88f8953031,
+    0xabcc77118461cefc, 0xfdc20d2b36ba7c3e, 0xd6bf94d5e57a42bc, 0x3d32907604691b4d,
+    0x8637bd05af6c69b5, 0xa63f9a49c2c1b110, 0xa7c5ac471b478423, 0x0fcf80dc33721d54,
+    0xd1b71758e219652b, 0xd3c36113404ea4a9, 0x83126e978d4fdf3b, 0x645a1cac083126ea,
+    0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4, 0xcccccccccccccccc, 0xcccccccccccccccd,
+    0x8000000000000000, 0x0000000000000000, 0xa000000000000000, 0x0000000000000000,
+    0xc800000000000000, 0x0000000000000000, 0xfa00000000000000, 0x0000000000000000,
+    0x9c40000000000000, 0x0000000000000000, 0xc350000000000000, 0x0000000000000000,
+    0xf424000000000000, 0x0000000000000000, 0x9896800000000000, 0x0000000000000000,
+    0xbebc200000000000, 0x0000000000000000, 0xee6b280000000000, 0x0000000000000000,
+    0x9502f90000000000, 0x0000000000000000, 0xba43b74000000000, 0x0000000000000000,
+    0xe8d4a51000000000, 0x0000000000000000, 0x9184e72a00000000, 0x0000000000000000,
+    0xb5e620f480000000, 0x0000000000000000, 0xe35fa931a0000000, 0x0000000000000000,
+    0x8e1bc9bf04000000, 0x0000000000000000, 0xb1a2bc2ec5000000, 0x0000000000000000,
+    0xde0b6b3a76400000, 0x0000000000000000, 0x8ac7230489e80000, 0x0000000000000000,
+    0xad78ebc5ac620000, 0x0000000000000000, 0xd8d726b7177a8000, 0x0000000000000000,
+    0x878678326eac9000, 0x0000000000000000, 0xa968163f0a57b400, 0x0000000000000000,
+    0xd3c21bcecceda100, 0x0000000000000000, 0x84595161401484a0, 0x0000000000000000,
+    0xa56fa5b99019a5c8, 0x0000000000000000, 0xcecb8f27f4200f3a, 0x0000000000000000,
+    0x813f3978f8940984, 0x4000000000000000, 0xa18f07d736b90be5, 0x5000000000000000,
+    0xc9f2c9cd04674ede, 0xa400000000000000, 0xfc6f7c4045812296, 0x4d00000000000000,
+    0x9dc5ada82b70b59d, 0xf020000000000000, 0xc5371912364ce305, 0x6c28000000000000,
+    0xf684df56c3e01bc6, 0xc732000000000000, 0x9a130b963a6c115c, 0x3c7f400000000000,
+    0xc097ce7bc90715b3, 0x4b9f100000000000, 0xf0bdc21abb48db20, 0x1e86d40000000000,
+    0x96769950b50d88f4, 0x1314448000000000, 0xbc143fa4e250eb31, 0x17d955a000000000,
+    0xeb194f8e1ae525fd, 0x5dcfab0800000000, 0x92efd1b8d0cf37be, 0x5aa1cae500000000,
+    0xb7abc627050305ad, 0xf14a3d9e40000000, 0xe596b7b0c643c719, 0x6d9ccd05d0000000,
+    0x8f7e32ce7bea5c6f, 0xe4820023a2000000, 0xb35dbf821ae4f38b, 0xdda2802c8a800000,
+    0xe0352f62a19e306e, 0xd50b2037ad200000, 0x8c213d9da502de45, 0x4526f422cc340000,
+    0xaf298d050e4395d6, 0x9670b12b7f410000, 0xdaf3f04651d47b4c, 0x3c0cdd765f114000,
+    0x88d8762bf324cd0f, 0xa5880a69fb6ac800, 0xab0e93b6efee0053, 0x8eea0d047a457a00,
+    0xd5d238a4abe98068, 0x72a4904598d6d880, 0x85a36366eb71f041, 0x47a6da2b7f864750,
+    0xa70c3c40a64e6c51, 0x999090b65f67d924, 0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d,
+    0x82818f1281ed449f, 0xbff8f10e7a8921a4, 0xa321f2d7226895c7, 0xaff72d52192b6a0d,
+    0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490, 0xfee50b7025c36a08, 0x02f236d04753d5b4,
+    0x9f4f2726179a2245, 0x01d762422c946590, 0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5,
+    0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2, 0x9b934c3b330c8577, 0x63cc55f49f88eb2f,
+    0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb, 0xf316271c7fc3908a, 0x8bef464e3945ef7a,
+    0x97edd871cfda3a56, 0x97758bf0e3cbb5ac, 0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317,
+    0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd, 0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a,
+    0xb975d6b6ee39e436, 0xb3e2fd538e122b44, 0xe7d34c64a9c85d44, 0x60dbbca87196b616,
+    0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd, 0xb51d13aea4a488dd, 0x6babab6398bdbe41,
+    0xe264589a4dcdab14, 0xc696963c7eed2dd1, 0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2,
+    0xb0de65388cc8ada8, 0x3b25a55f43294bcb, 0xdd15fe86affad912, 0x49ef0eb713f39ebe,
+    0x8a2dbf142dfcc7ab, 0x6e3569326c784337, 0xacb92ed9397bf996, 0x49c2c37f07965404,
+    0xd7e77a8f87daf7fb, 0xdc33745ec97be906, 0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3,
+    0xa8acd7c0222311bc, 0xc40832ea0d68ce0c, 0xd2d80db02aabd62b, 0xf50a3fa490c30190,
+    0x83c7088e1aab65db, 0x792667c6da79e0fa, 0xa4b8cab1a1563f52, 0x577001b891185938,
+    0xcde6fd5e09abcf26, 0xed4c0226b55e6f86, 0x80b05e5ac60b6178, 0x544f8158315b05b4,
+    0xa0dc75f1778e39d6, 0x696361ae3db1c721, 0xc913936dd571c84c, 0x03bc3a19cd1e38e9,
+    0xfb5878494ace3a5f, 0x04ab48a04065c723, 0x9d174b2dcec0e47b, 0x62eb0d64283f9c76,
+    0xc45d1df942711d9a, 0x3ba5d0bd324f8394, 0xf5746577930d6500, 0xca8f44ec7ee36479,
+    0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb, 0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e,
+    0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e, 0x95d04aee3b80ece5, 0xbba1f1d158724a12,
+    0xbb445da9ca61281f, 0x2a8a6e45ae8edc97, 0xea1575143cf97226, 0xf52d09d71a3293bd,
+    0x924d692ca61be758, 0x593c2626705f9c56, 0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c,
+    0xe498f455c38b997a, 0x0b6dfb9c0f956447, 0x8edf98b59a373fec, 0x4724bd4189bd5eac,
+    0xb2977ee300c50fe7, 0x58edec91ec2cb657, 0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed,
+    0x8b865b215899f46c, 0xbd79e0d20082ee74, 0xae67f1e9aec07187, 0xecd8590680a3aa11,
+    0xda01ee641a708de9, 0xe80e6f4820cc9495, 0x884134fe908658b2, 0x3109058d147fdcdd,
+    0xaa51823e34a7eede, 0xbd4b46f0599fd415, 0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a,
+    0x850fadc09923329e, 0x03e2cf6bc604ddb0, 0xa6539930bf6bff45, 0x84db8346b786151c,
+    0xcfe87f7cef46ff16, 0xe612641865679a63, 0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e,
+    0xa26da3999aef7749, 0xe3be5e330f38f09d, 0xcb090c8001ab551c, 0x5cadf5bfd3072cc5,
+    0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6, 0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa,
+    0xc646d63501a1511d, 0xb281e1fd541501b8, 0xf7d88bc24209a565, 0x1f225a7ca91a4226,
+    0x9ae757596946075f, 0x3375788de9b06958, 0xc1a12d2fc3978937, 0x0052d6b1641c83ae,
+    0xf209787bb47d6b84, 0xc0678c5dbd23a49a, 0x9745eb4d50ce6332, 0xf840b7ba963646e0,
+    0xbd176620a501fbff, 0xb650e5a93bc3d898, 0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe,
+    0x93ba47c980e98cdf, 0xc66f336c36b10137, 0xb8a8d9bbe123f017, 0xb80b0047445d4184,
+    0xe6d3102ad96cec1d, 0xa60dc059157491e5, 0x9043ea1ac7e41392, 0x87c89837ad68db2f,
+    0xb454e4a179dd1877, 0x29babe4598c311fb, 0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a,
+    0x8ce2529e2734bb1d, 0x1899e4a65f58660c, 0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f,
+    0xdc21a1171d42645d, 0x76707543f4fa1f73, 0x899504ae72497eba, 0x6a06494a791c53a8,
+    0xabfa45da0edbde69, 0x0487db9d17636892, 0xd6f8d7509292d603, 0x45a9d2845d3c42b6,
+    0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2, 0xa7f26836f282b732, 0x8e6cac7768d7141e,
+    0xd1ef0244af2364ff, 0x3207d795430cd926, 0x8335616aed761f1f, 0x7f44e6bd49e807b8,
+    0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6, 0xcd036837130890a1, 0x36dba887c37a8c0f,
+    0x802221226be55a64, 0xc2494954da2c9789, 0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c,
+    0xc83553c5c8965d3d, 0x6f92829494e5acc7, 0xfa42a8b73abbf48c, 0xcb772339ba1f17f9,
+    0x9c69a97284b578d7, 0xff2a760414536efb, 0xc38413cf25e2d70d, 0xfef5138519684aba,
+    0xf46518c2ef5b8cd1, 0x7eb258665fc25d69, 0x98bf2f79d5993802, 0xef2f773ffbd97a61,
+    0xbeeefb584aff8603, 0xaafb550ffacfd8fa, 0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38,
+    0x952ab45cfa97a0b2, 0xdd945a747bf26183, 0xba756174393d88df, 0x94f971119aeef9e4,
+    0xe912b9d1478ceb17, 0x7a37cd5601aab85d, 0x91abb422ccb812ee, 0xac62e055c10ab33a,
+    0xb616a12b7fe617aa, 0x577b986b314d6009, 0xe39c49765fdf9d94, 0xed5a7e85fda0b80b,
+    0x8e41ade9fbebc27d, 0x14588f13be847307, 0xb1d219647ae6b31c, 0x596eb2d8ae258fc8,
+    0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb, 0x8aec23d680043bee, 0x25de7bb9480d5854,
+    0xada72ccc20054ae9, 0xaf561aa79a10ae6a, 0xd910f7ff28069da4, 0x1b2ba1518094da04,
+    0x87aa9aff79042286, 0x90fb44d2f05d0842, 0xa99541bf57452b28, 0x353a1607ac744a53,
+    0xd3fa922f2d1675f2, 0x42889b8997915ce8, 0x847c9b5d7c2e09b7, 0x69956135febada11,
+    0xa59bc234db398c25, 0x43fab9837e699095, 0xcf02b2c21207ef2e, 0x94f967e45e03f4bb,
+    0x8161afb94b44f57d, 0x1d1be0eebac278f5, 0xa1ba1ba79e1632dc, 0x6462d92a69731732,
+    0xca28a291859bbf93, 0x7d7b8f7503cfdcfe, 0xfcb2cb35e702af78, 0x5cda735244c3d43e,
+    0x9defbf01b061adab, 0x3a0888136afa64a7, 0xc56baec21c7a1916, 0x088aaa1845b8fdd0,
+    0xf6c69a72a3989f5b, 0x8aad549e57273d45, 0x9a3c2087a63f6399, 0x36ac54e2f678864b,
+    0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd, 0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5,
+    0x969eb7c47859e743, 0x9f644ae5a4b1b325, 0xbc4665b596706114, 0x873d5d9f0dde1fee,
+    0xeb57ff22fc0c7959, 0xa90cb506d155a7ea, 0x9316ff75dd87cbd8, 0x09a7f12442d588f2,
+    0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f, 0xe5d3ef282a242e81, 0x8f1668c8a86da5fa,
+    0x8fa475791a569d10, 0xf96e017d694487bc, 0xb38d92d760ec4455, 0x37c981dcc395a9ac,
+    0xe070f78d3927556a, 0x85bbe253f47b1417, 0x8c469ab843b89562, 0x93956d7478ccec8e,
+    0xaf58416654a6babb, 0x387ac8d1970027b2, 0xdb2e51bfe9d0696a, 0x06997b05fcc0319e,
+    0x88fcf317f22241e2, 0x441fece3bdf81f03, 0xab3c2fddeeaad25a, 0xd527e81cad7626c3,
+    0xd60b3bd56a5586f1, 0x8a71e223d8d3b074, 0x85c7056562757456, 0xf6872d5667844e49,
+    0xa738c6bebb12d16c, 0xb428f8ac016561db, 0xd106f86e69d785c7, 0xe13336d701beba52,
+    0x82a45b450226b39c, 0xecc0024661173473, 0xa34d721642b06084, 0x27f002d7f95d0190,
+    0xcc20ce9bd35c78a5, 0x31ec038df7b441f4, 0xff290242c83396ce, 0x7e67047175a15271,
+    0x9f79a169bd203e41, 0x0f0062c6e984d386, 0xc75809c42c684dd1, 0x52c07b78a3e60868,
+    0xf92e0c3537826145, 0xa7709a56ccdf8a82, 0x9bbcc7a142b17ccb, 0x88a66076400bb691,
+    0xc2abf989935ddbfe, 0x6acff893d00ea435, 0xf356f7ebf83552fe, 0x0583f6b8c4124d43,
+    0x98165af37b2153de, 0xc3727a337a8b704a, 0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c,
+    0xeda2ee1c7064130c, 0x1162def06f79df73, 0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8,
+    0xb9a74a0637ce2ee1, 0x6d953e2bd7173692, 0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437,
+    0x910ab1d4db9914a0, 0x1d9c9892400a22a2, 0xb54d5e4a127f59c8, 0x2503beb6d00cab4b,
+    0xe2a0b5dc971f303a, 0x2e44ae64840fd61d, 0x8da471a9de737e24, 0x5ceaecfed289e5d2,
+    0xb10d8e1456105dad, 0x7425a83e872c5f47, 0xdd50f1996b947518, 0xd12f124e28f77719,
+    0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f, 0xace73cbfdc0bfb7b, 0x636cc64d1001550b,
+    0xd8210befd30efa5a, 0x3c47f7e05401aa4e, 0x8714a775e3e95c78, 0x65acfaec34810a71,
+    0xa8d9d1535ce3b396, 0x7f1839a741a14d0d, 0xd31045a8341ca07c, 0x1ede48111209a050,
+    0x83ea2b892091e44d, 0x934aed0aab460432, 0xa4e4b66b68b65d60, 0xf81da84d5617853f,
+    0xce1de40642e3f4b9, 0x36251260ab9d668e, 0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019,
+    0xa1075a24e4421730, 0xb24cf65b8612f81f, 0xc94930ae1d529cfc, 0xdee033f26797b627,
+    0xfb9b7cd9a4a7443c, 0x169840ef017da3b1, 0x9d412e0806e88aa5, 0x8e1f289560ee864e,
+    0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2, 0xf5b5d7ec8acb58a2, 0xae10af696774b1db,
+    0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29, 0xbff610b0cc6edd3f, 0x17fd090a58d32af3,
+    0xeff394dcff8a948e, 0xddfc4b4cef07f5b0, 0x95f83d0a1fb69cd9, 0x4abdaf101564f98e,
+    0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1, 0xea53df5fd18d5513, 0x84c86189216dc5ed,
+    0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4, 0xb7118682dbb66a77, 0x3fbc8c33221dc2a1,
+    0xe4d5e82392a40515, 0x0fabaf3feaa5334a, 0x8f05b1163ba6832d, 0x29cb4d87f2a7400e,
+    0xb2c71d5bca9023f8, 0x743e20e9ef511012, 0xdf78e4b2bd342cf6, 0x914da9246b255416,
+    0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e, 0xae9672aba3d0c320, 0xa184ac2473b529b1,
+    0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e, 0x8865899617fb1871, 0x7e2fa67c7a658892,
+    0xaa7eebfb9df9de8d, 0xddbb901b98feeab7, 0xd51ea6fa85785631, 0x552a74227f3ea565,
+    0x8533285c936b35de, 0xd53a88958f87275f, 0xa67ff273b8460356, 0x8a892abaf368f137,
+    0xd01fef10a657842c, 0x2d2b7569b0432d85, 0x8213f56a67f6b29b, 0x9c3b29620e29fc73,
+    0xa298f2c501f45f42, 0x8349f3ba91b47b8f, 0xcb3f2f7642717713, 0x241c70a936219a73,
+    0xfe0efb53d30dd4d7, 0xed238cd383aa0110, 0x9ec95d1463e8a506, 0xf4363804324a40aa,
+    0xc67bb4597ce2ce48, 0xb143c6053edcd0d5, 0xf81aa16fdc1b81da, 0xdd94b7868e94050a,
+    0x9b10a4e5e9913128, 0xca7cf2b4191c8326, 0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0,
+    0xf24a01a73cf2dccf, 0xbc633b39673c8cec, 0x976e41088617ca01, 0xd5be0503e085d813,
+    0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18, 0xec9c459d51852ba2, 0xddf8e7d60ed1219e,
+    0x93e1ab8252f33b45, 0xcabb90e5c942b503, 0xb8da1662e7b00a17, 0x3d6a751f3b936243,
+    0xe7109bfba19c0c9d, 0x0cc512670a783ad4, 0x906a617d450187e2, 0x27fb2b80668b24c5,
+    0xb484f9dc9641e9da, 0xb1f9f660802dedf6, 0xe1a63853bbd26451, 0x5e7873f8a0396973,
+    0x8d07e33455637eb2, 0xdb0b487b6423e1e8, 0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62,
+    0xdc5c5301c56b75f7, 0x7641a140cc7810fb, 0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d,
+    0xac2820d9623bf429, 0x546345fa9fbdcd44, 0xd732290fbacaf133, 0xa97c177947ad4095,
+    0x867f59a9d4bed6c0, 0x49ed8eabcccc485d, 0xa81f301449ee8c70, 0x5c68f256bfff5a74,
+    0xd226fc195c6a2f8c, 0x73832eec6fff3111, 0x83585d8fd9c25db7, 0xc831fd53c5ff7eab,
+    0xa42e74f3d032f525, 0xba3e7ca8b77f5e55, 0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb,
+    0x80444b5e7aa7cf85, 0x7980d163cf5b81b3, 0xa0555e361951c366, 0xd7e105bcc332621f,
+    0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7, 0xfa856334878fc150, 0xb14f98f6f0feb951,
+    0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3, 0xc3b8358109e84f07, 0x0a862f80ec4700c8,
+    0xf4a642e14c6262c8, 0xcd27bb612758c0fa, 0x98e7e9cccfbd7dbd, 0x8038d51cb897789c,
+    0xbf21e44003acdd2c, 0xe0470a63e6bd56c3, 0xeeea5d5004981478, 0x1858ccfce06cac74,
+    0x95527a5202df0ccb, 0x0f37801e0c43ebc8, 0xbaa718e68396cffd, 0xd30560258f54e6ba,
+    0xe950df20247c83fd, 0x47c6b82ef32a2069, 0x91d28b7416cdd27e, 0x4cdc331d57fa5441,
+    0xb6472e511c81471d, 0xe0133fe4adf8e952, 0xe3d8f9e563a198e5, 0x58180fddd97723a6,
+    0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648
+};
+
+uint64_t _full_multiplication(uint64_t a, uint64_t b, uint64_t *hi)
 {
-    _initialize(s);
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *hi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *hi = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t)lo_lo;
+#endif
 }
 
-JSON::Object::Object(std::string &s)
+int _leading_zeroes(uint64_t x)
 {
-    _initialize(s.c_str());
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for (; !(x & ((uint64_t)1 << 63)); x <<= 1)
+    {
+        n++;
+    }
+    return n;
+#endif
 }
 
-JSON::Object::Object(const char *s, const char **r)
+double _make_double(uint64_t mantissa, int power2, bool negative)
 {
-    *r = _initialize(s);
+    uint64_t bits = mantissa | ((uint64_t)power2 << 52) | ((uint64_t)negative << 63);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
 }
 
-const char *JSON::Object::_initialize(const char *s)
+// Eisel-Lemire: computes the biased exponent and the 52 explicit mantissa
+// bits of w * 10^q, rounded to nearest even. w must be non-zero.
+void _eisel_lemire(int64_t q, uint64_t w, uint64_t *mantissa, int *power2)
 {
-    if (s == NULL)
+    if (q < -342)
     {
-        throw JSON::DecodeException(0);
+        *mantissa = 0;
+        *power2 = 0;
+        return;
     }
 
-    int line = 1;
-    std::vector<JSON::_Node *> nodes;
+    if (q > 308)
+    {
+        *mantissa = 0;
+        *power2 = 0x7FF;
+        return;
+    }
 
-    try
+    int lz = _leading_zeroes(w);
+    w <<= lz;
+
+    size_t index = 2 * (size_t)(q + 342);
+    uint64_t hi;
+    uint64_t lo = _full_multiplication(w, _powers_of_five_128[index], &hi);
+
+    // Only consult the low half of the power when the high product does not
+    // already settle the 55 bits that are needed
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFull >> 55;
+    if ((hi & precision_mask) == precision_mask)
     {
-        s = _consume_whitespace(s, &line);
-        if (*s == '[')
-        {
-            _is_array = true;
-        }
-        else if (*s == '{')
+        uint64_t second_hi;
+        _full_multiplication(w, _powers_of_five_128[index + 1], &second_hi);
+        lo += second_hi;
+        if (second_hi > lo)
         {
-            _is_array = false;
+            hi++;
         }
-        else
+    }
+
+    int upperbit = (int)(hi >> 63);
+    int shift = upperbit + 64 - 52 - 3;
+    uint64_t m = hi >> shift;
+    int p = (int)(((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+
+    if (p <= 0)
+    {
+        // Subnormal
+        if (-p + 1 >= 64)
         {
-            throw JSON::DecodeException(line);
+            *mantissa = 0;
+            *power2 = 0;
+            return;
         }
 
-        s = _consume_whitespace(s + 1, &line);
-        if (*s != (_is_array ? ']' : '}'))
-        {
-            while (true)
-            {
-                s = _consume_whitespace(s, &line);
+        m >>= -p + 1;
+        m += m & 1;
+        m >>= 1;
+        *mantissa = m & (((uint64_t)1 << 52) - 1);
+        *power2 = m < ((uint64_t)1 << 52) ? 0 : 1;
+        return;
+    }
 
-                // Anticipate next node
-                JSON::_Node *node = new JSON::_Node();
-                nodes.push_back(node);
+    // A product that lands exactly between two doubles must round to even
+    if (lo <= 1 && q >= -4 && q <= 23 && (m & 3) == 1 && (m << shift) == hi)
+    {
+        m &= ~(uint64_t)1;
+    }
+
+    m += m & 1;
+    m >>= 1;
+    if (m >= ((uint64_t)2 << 52))
+    {
+        m = (uint64_t)1 << 52;
+        p++;
+    }
+
+    m &= ~((uint64_t)1 << 52);
+    if (p >= 0x7FF)
+    {
+        p = 0x7FF;
+        m = 0;
+    }
+
+    *mantissa = m;
+    *power2 = p;
+}
+
+void _bigint_trim(std::vector<uint32_t> &a)
+{
+    while (a.size() > 1 && a.back() == 0)
+    {
+        a.pop_back();
+    }
+}
+
+void _bigint_mul_small(std::vector<uint32_t> &a, uint32_t m, uint32_t add)
+{
+    uint64_t carry = add;
+    for (auto &limb : a)
+    {
+        uint64_t t = (uint64_t)limb * m + carry;
+        limb = (uint32_t)t;
+        carry = t >> 32;
+    }
+
+    if (carry != 0)
+    {
+        a.push_back((uint32_t)carry);
+    }
+}
+
+void _bigint_mul_pow5(std::vector<uint32_t> &a, int64_t e)
+{
+    for (; e >= 13; e -= 13)
+    {
+        _bigint_mul_small(a, 1220703125, 0);
+    }
+
+    uint32_t m = 1;
+    for (; e > 0; e--)
+    {
+        m *= 5;
+    }
+
+    _bigint_mul_small(a, m, 0);
+}
+
+void _bigint_shl(std::vector<uint32_t> &a, size_t bits)
+{
+    a.insert(a.begin(), bits / 32, 0);
+
+    unsigned int shift = bits % 32;
+    if (shift != 0)
+    {
+        uint32_t carry = 0;
+        for (auto &limb : a)
+        {
+            uint32_t next = limb >> (32 - shift);
+            limb = (limb << shift) | carry;
+            carry = next;
+        }
+
+        if (carry != 0)
+        {
+            a.push_back(carry);
+        }
+    }
+}
+
+void _bigint_shr1(std::vector<uint32_t> &a)
+{
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        a[i] = (a[i] >> 1) | (i + 1 < a.size() ? a[i + 1] << 31 : 0);
+    }
+
+    _bigint_trim(a);
+}
+
+size_t _bigint_bits(const std::vector<uint32_t> &a)
+{
+    size_t n = (a.size() - 1) * 32;
+    for (uint32_t top = a.back(); top != 0; top >>= 1)
+    {
+        n++;
+    }
+
+    return n;
+}
+
+int _bigint_compare(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+{
+    if (a.size() != b.size())
+    {
+        return a.size() < b.size() ? -1 : 1;
+    }
+
+    for (size_t i = a.size(); i-- > 0;)
+    {
+        if (a[i] != b[i])
+        {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+void _bigint_sub(std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+{
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        int64_t t = (int64_t)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = t < 0;
+        a[i] = (uint32_t)(t + (borrow << 32));
+    }
+
+    _bigint_trim(a);
+}
+
+// Rounds (q + f) * 2^e to the nearest double, where 0 <= f < 1 and f is
+// non-zero exactly when sticky is set
+double _round_to_double(uint64_t q, int64_t e, bool sticky, bool negative)
+{
+    int lz = _leading_zeroes(q);
+    q <<= lz;
+    e -= lz;
+
+    int64_t drop = 11;
+    if (63 + e < -1022)
+    {
+        drop += -1022 - (63 + e);
+    }
+
+    if (drop > 64)
+    {
+        return negative ? -0.0 : 0.0;
+    }
+
+    uint64_t m = drop == 64 ? 0 : q >> drop;
+    uint64_t rest = drop == 64 ? q : q & (((uint64_t)1 << drop) - 1);
+    uint64_t half = (uint64_t)1 << (drop - 1);
+
+    if (rest > half || (rest == half && (sticky || (m & 1))))
+    {
+        m++;
+    }
+
+    double d = ldexp((double)m, (int)(e + drop));
+    return negative ? -d : d;
+}
+
+// Exact conversion of the digits in [s, end), which may contain a decimal
+// point, scaled by 10^exponent
+double _decimal_to_double_exact(const char *s, const char *end, int64_t exponent, bool negative)
+{
+    std::vector<uint32_t> num(1, 0);
+    size_t digits = 0;
+    bool fraction = false;
+    bool sticky = false;
+    uint32_t chunk = 0;
+    uint32_t scale = 1;
+
+    for (; s < end; s++)
+    {
+        if (*s == '.')
+        {
+            fraction = true;
+            continue;
+        }
+
+        if (digits == 0 && *s == '0')
+        {
+            exponent -= fraction;
+            continue;
+        }
+
+        // Digits beyond what can affect rounding only matter if non-zero
+        if (digits >= 800)
+        {
+            sticky |= *s != '0';
+            exponent += !fraction;
+            continue;
+        }
+
+        chunk = chunk * 10 + (*s - '0');
+        scale *= 10;
+        digits++;
+        exponent -= fraction;
+
+        if (scale == 1000000000)
+        {
+            _bigint_mul_small(num, scale, chunk);
+            chunk = 0;
+            scale = 1;
+        }
+    }
+
+    _bigint_mul_small(num, scale, chunk);
+
+    if (sticky)
+    {
+        _bigint_mul_small(num, 10, 1);
+        exponent--;
+        digits++;
+    }
+
+    if (digits == 0 || (int64_t)digits + exponent < -330)
+    {
+        return negative ? -0.0 : 0.0;
+    }
+
+    if ((int64_t)digits + exponent > 310)
+    {
+        return negative ? -HUGE_VAL : HUGE_VAL;
+    }
+
+    std::vector<uint32_t> den(1, 1);
+    if (exponent > 0)
+    {
+        _bigint_mul_pow5(num, exponent);
+    }
+    else
+    {
+        _bigint_mul_pow5(den, -exponent);
+    }
+
+    // Scale so that the quotient has 63 or 64 bits
+    int64_t shift = 63 - ((int64_t)_bigint_bits(num) - (int64_t)_bigint_bits(den));
+    if (shift > 0)
+    {
+        _bigint_shl(num, shift);
+    }
+    else
+    {
+        _bigint_shl(den, -shift);
+    }
+
+    _bigint_shl(den, 63);
+
+    uint64_t q = 0;
+    for (int i = 63; i >= 0; i--)
+    {
+        if (_bigint_compare(num, den) >= 0)
+        {
+            _bigint_sub(num, den);
+            q |= (uint64_t)1 << i;
+        }
+
+        _bigint_shr1(den);
+    }
+
+    bool remainder = num.size() > 1 || num[0] != 0;
+    return _round_to_double(q, exponent - shift, remainder, negative);
+}
+
+/*
+ * Binary to decimal conversion
+ *
+ * Doubles are formatted with Ryu, which finds the shortest decimal string
+ * that parses back to the same double. Integers below 2^53 skip straight
+ * to integer formatting.
+ */
+
+// floor(2^(bitlength(5^i) + 124) / 5^i) + 1 for i in [0, 342), low word first
+const uint64_t _ryu_pow5_inv_split[] = {
+    0x0000000000000001, 0x2000000000000000, 0x999999999999999a, 0x1999999999999999,
+    0x47ae147ae147ae15, 0x147ae147ae147ae1, 0x6c8b4395810624de, 0x10624dd2f1a9fbe7,
+    0x7a786c226809d496, 0x1a36e2eb1c432ca5, 0x61f9f01b866e43ab, 0x14f8b588e368f084,
+    0xb4c7f34938583622, 0x10c6f7a0b5ed8d36, 0x87a6520ec08d236a, 0x1ad7f29abcaf4857,
+    0x9fb841a566d74f88, 0x15798ee2308c39df, 0xe62d01511f12a607, 0x112e0be826d694b2,
+    0xd6ae6881cb5109a4, 0x1b7cdfd9d7bdbab7, 0xdef1ed34a2a73aea, 0x15fd7fe17964955f,
+    0x7f27f0f6e885c8bb, 0x119799812dea1119, 0x650cb4be40d60df8, 0x1c25c268497681c2,
+    0xea70909833de7193, 0x16849b86a12b9b01, 0x21f3a6e0297ec143, 0x1203af9ee756159b,
+    0x6985d7cd0f313537, 0x1cd2b297d889bc2b, 0x2137dfd73f5a90f9, 0x170ef54646d49689,
+    0xe75fe645cc4873fa, 0x12725dd1d243aba0, 0xa5663d3c7a0d865d, 0x1d83c94fb6d2ac34,
+    0x511e976394d79eb1, 0x179ca10c9242235d, 0xda7edf82dd794bc1, 0x12e3b40a0e9b4f7d,
+    0x2a6498d1625bac68, 0x1e392010175ee596, 0xeeb6e0a781e2f053, 0x182db34012b25144,
+    0x58924d52ce4f26a9, 0x1357c299a88ea76a, 0x27507bb7b07ea441, 0x1ef2d0f5da7dd8aa,
+    0x52a6c95fc0655034, 0x18c240c4aecb13bb, 0x0eebd44c99eaa690, 0x13ce9a36f23c0fc9,
+    0xb17953adc3110a80, 0x1fb0f6be50601941, 0xc12ddc8b02740867, 0x195a5efea6b34767,
+    0x3424b06f3529a052, 0x14484bfeebc29f86, 0x901d59f290ee19db, 0x1039d66589687f9e,
+    0x4cfbc31db4b0295f, 0x19f623d5a8a73297, 0x3d9635b15d59bab2, 0x14c4e977ba1f5bac,
+    0x97ab5e277de16228, 0x109d8792fb4c4956, 0xf2abc9d8c9689d0d, 0x1a95a5b7f87a0ef0,
+    0x5bbca17a3aba173e, 0x154484932d2e725a, 0xafca1ac82efb45cb, 0x11039d428a8b8eae,
+    0xb2dcf7a6b1920945, 0x1b38fb9daa78e44a, 0xf57d92ebc141a104, 0x15c72fb1552d836e,
+    0xc46475896767b403, 0x116c262777579c58, 0x6d6d88dbd8a5ecd2, 0x1be03d0bf225c6f4,
+    0x8abe071646eb23db, 0x164cfda3281e38c3, 0x6efe6c11d255b649, 0x11d7314f534b609c,
+    0xb197134fb6ef8a0e, 0x1c8b821885456760, 0x27ac0f72f8bfa1a5, 0x16d601ad376ab91a,
+    0xb95672c260994e1e, 0x1244ce242c5560e1, 0xf5571e03cdc21695, 0x1d3ae36d13bbce35,
+    0x2aac18030b01abab, 0x17624f8a762fd82b, 0xbbbce0026f348956, 0x12b50c6ec4f31355,
+    0x92c7ccd0b1eda889, 0x1dee7a4ad4b81eef, 0xdbd30a408e57ba07, 0x17f1fb6f10934bf2,
+    0x7ca8d50071dfc806, 0x1327fc58da0f6ff5, 0xfaa7bb33e9660cd6, 0x1ea6608e29b24cbb,
+    0x9552fc298784d711, 0x18851a0b548ea3c9, 0xaaa8c9bad2d0ac0e, 0x139dae6f76d88307,
+    0xdddadc5e1e1aace3, 0x1f62b0b257c0d1a5, 0x7e48b04b4b488a4f, 0x191bc08eac9a4151,
+    0xcb6d59d5d5d3a1d9, 0x141633a556e1cdda, 0x3c577b1177dc817b, 0x1011c2eaabe7d7e2,
+    0xc6f25e825960cf2a, 0x19b604aaaca62636, 0x6bf518684780a5bb, 0x14919d5556eb51c5,
+    0x232a79ed06008496, 0x10747ddddf22a7d1, 0xd1dd8fe1a3340756, 0x1a53fc9631d10c81,
+    0xa7e4731ae8f66c45, 0x150ffd44f4a73d34, 0x531d28e253f8569e, 0x10d9976a5d52975d,
+    0xeb61db03b98d5762, 0x1af5bf109550f22e, 0xbc4e48cfc7a445e8, 0x159165a6ddda5b58,
+    0x6371d3d96c836b20, 0x11411e1f17e1e2ad, 0x9f1c8628ad9f11cd, 0x1b9b6364f3030448,
+    0xe5b06b53be18db0b, 0x1615e91d8f359d06, 0xeaf3890fcb4715a2, 0x11ab20e472914a6b,
+    0x44b8db4c7871bc37, 0x1c45016d841baa46, 0x03c715d6c6c1635f, 0x169d9abe03495505,
+    0x3638de456bcde919, 0x1217aefe69077737, 0x56c163a2461641c1, 0x1cf2b1970e725858,
+    0xdf011c81d1ab67ce, 0x17288e1271f51379, 0x7f3416ce4155eca5, 0x1286d80ec190dc61,
+    0x6520247d3556476e, 0x1da48ce468e7c702, 0xea801d30f7783925, 0x17b6d71d20b96c01,
+    0xbb99b0f3f92cfa84, 0x12f8ac174d612334, 0x5f5c4e532847f739, 0x1e5aacf215683854,
+    0x7f7d0b75b9d32c2e, 0x18488a5b44536043, 0x9930d5f7c7dc2358, 0x136d3b7c36a919cf,
+    0x8eb4898c72f9d226, 0x1f152bf9f10e8fb2, 0x722a07a38f2e41b8, 0x18ddbcc7f40ba628,
+    0xc1bb394fa5be9afa, 0x13e497065cd61e86, 0x9c5ec2190930f7f6, 0x1fd424d6faf030d7,
+    0x49e56814075a5ff8, 0x197683df2f268d79, 0x6e51201005e1e660, 0x145ecfe5bf520ac7,
+    0xf1da800cd181851a, 0x104bd984990e6f05, 0x4fc400148268d4f5, 0x1a12f5a0f4e3e4d6,
+    0xd96999aa01ed772b, 0x14dbf7b3f71cb711, 0xadee1488018ac5bc, 0x10aff95cc5b09274,
+    0x497ceda668de092c, 0x1ab328946f80ea54, 0x3aca57b853e4d424, 0x155c2076bf9a5510,
+    0x623b7960431d7683, 0x1116805effaeaa73, 0x9d2bf566d1c8bd9e, 0x1b5733cb32b110b8,
+    0x7dbcc452416d647f, 0x15df5ca28ef40d60, 0xcafd69db678ab6cc, 0x117f7d4ed8c33de6,
+    0xab2f0fc572778adf, 0x1bff2ee48e052fd7, 0x88f273045b92d580, 0x1665bf1d3e6a8cac,
+    0xd3f528d049424466, 0x11eaff4a98553d56, 0xb988414d4203a0a3, 0x1cab3210f3bb9557,
+    0x6139cdd76802e6e9, 0x16ef5b40c2fc7779, 0xe761717920025254, 0x125915cd68c9f92d,
+    0xa568b58e999d5086, 0x1d5b561574765b7c, 0x5120913ee14aa6d2, 0x177c44ddf6c515fd,
+    0xa74d40ff1aa21f0e, 0x12c9d0b1923744ca, 0x0baece64f769cb4a, 0x1e0fb44f50586e11,
+    0x3c8bd850c5ee3c3b, 0x180c903f7379f1a7, 0xca0979da37f1c9c9, 0x133d4032c2c7f485,
+    0xa9a8c2f6bfe942db, 0x1ec866b79e0cba6f, 0x2153cf2bccba9be3, 0x18a0522c7e709526,
+    0x1aa9728970954982, 0x13b374f06526ddb8, 0xf775840f1a88759d, 0x1f8587e7083e2f8c,
+    0x5f9136727ba05e17, 0x19379fec0698260a, 0x1940f85b9619e4df, 0x142c7ff0054684d5,
+    0xe100c6afab47ea4c, 0x1023998cd1053710, 0xce67a44c453fdd47, 0x19d28f47b4d524e7,
+    0xd852e9d69dccb106, 0x14a8729fc3ddb71f, 0x79dbee454b0a2738, 0x1086c219697e2c19,
+    0x295fe3a211a9d859, 0x1a71368f0f30468f, 0xbab31c81a7bb137a, 0x15275ed8d8f36ba5,
+    0x6228e39aec95a92f, 0x10ec4be0ad8f8951, 0x9d0e38f7e0ef7517, 0x1b13ac9aaf4c0ee8,
+    0xb0d82d931a592a79, 0x15a956e225d67253, 0x8d79be0f4847552e, 0x11544581b7dec1dc,
+    0x158f967eda0bbb7c, 0x1bba08cf8c979c94, 0x77a611ff14d62f97, 0x162e6d72d6dfb076,
+    0xf951a7ff43de8c79, 0x11bebdf578b2f391, 0xc21c3ffed2fdad8e, 0x1c6463225ab7ec1c,
+    0x01b0333242648ad8, 0x16b6b5b5155ff017, 0x0159c28e9b83a246, 0x122bc490dde659ac,
+    0xcef604175f3903a3, 0x1d12d41afca3c2ac, 0x725e69ac4c2d9c83, 0x17424348ca1c9bbd,
+    0xf5185489d68ae39c, 0x129b69070816e2fd, 0xee8d540fbdab05c6, 0x1dc574d80cf16b2f,
+    0xbed77672fe226b05, 0x17d12a4670c1228c, 0xff12c528cb4ebc04, 0x130dbb6b8d674ed6,
+    0xcb513b74787df9a0, 0x1e7c5f127bd87e24, 0x090dc929f9fe614d, 0x18637f41fcad31b7,
+    0xa0d7d42194cb810a, 0x1382cc34ca2427c5, 0x67bfb9cf5478ce77, 0x1f37ad21436d0c6f,
+    0x1fcc94a5dd2d71f9, 0x18f9574dcf8a7059, 0x7fd6dd517dbdf4c7, 0x13faac3e3fa1f37a,
+    0xffbe2ee8c92fee0b, 0x1ff779fd329cb8c3, 0x6631bf20a0f324d6, 0x1992c7fdc216fa36,
+    0xb827cc1a1a5c1d78, 0x14756ccb01abfb5e, 0x935309ae7b7ce460, 0x105df0a267bcc918,
+    0x1eeb42b0c594a099, 0x1a2fe76a3f9474f4, 0xe58902270476e6e1, 0x14f31f8832dd2a5c,
+    0xb7a0ce859d2bebe7, 0x10c27fa028b0eeb0, 0x59014a6f61dfdfd8, 0x1ad0cc33744e4ab4,
+    0xe0cdd525e7e64cad, 0x1573d68f903ea229, 0x4d7177518651d6f1, 0x11297872d9cbb4ee,
+    0x7be8bee8d6e957e8, 0x1b758d848fac54b0, 0xfcba3253df211320, 0x15f7a46a0c89dd59,
+    0x63c8284318e74280, 0x1192e9ee706e4aae, 0x060d0d3827d86a66, 0x1c1e43171a4a1117,
+    0x6b3da42cecad21eb, 0x167e9c127b6e7412, 0x88fe1cf0bd574e56, 0x11fee341fc585cdb,
+    0x419694b462254a23, 0x1ccb0536608d615f, 0x67abaa29e81dd4e9, 0x1708d0f84d3de77f,
+    0xb95621bb2017dd87, 0x126d73f9d764b932, 0xc223692b668c95a5, 0x1d7becc2f23ac1ea,
+    0xce82ba891ed6de1d, 0x179657025b6234bb, 0xa53562074bdf1818, 0x12deac01e2b4f6fc,
+    0x3b889cd87964f359, 0x1e3113363787f194, 0xfc6d4a46c783f5e1, 0x18274291c6065adc,
+    0x30576e9f06032b1a, 0x13529ba7d19eaf17, 0x1a257dcb3cd1de90, 0x1eea92a61c311825,
+    0x481dfe3c30a7e540, 0x18bba884e35a79b7, 0xd34b31c9c0865100, 0x13c9539d82aec7c5,
+    0x5211e942cda3b4cd, 0x1fa885c8d117a609, 0x74db21023e1c90a4, 0x19539e3a40dfb807,
+    0xf715b401cb4a0d50, 0x1442e4fb67196005, 0xf8de299b09080aa7, 0x103583fc527ab337,
+    0x8e304291a80cddd7, 0x19ef3993b72ab859, 0x3e8d020e200a4b13, 0x14bf6142f8eef9e1,
+    0x653d9b3e80083c0f, 0x10991a9bfa58c7e7, 0x6ec8f864000d2ce4, 0x1a8e90f9908e0ca5,
+    0x8bd3f9e999a423ea, 0x153eda614071a3b7, 0x3ca994bae1501cbb, 0x10ff151a99f482f9,
+    0xc775bac49bb3612b, 0x1b31bb5dc320d18e, 0xd2c4956a16291a89, 0x15c162b168e70e0b,
+    0xdbd0778811ba7ba1, 0x11678227871f3e6f, 0x2c80bf401c5d929b, 0x1bd8d03f3e9863e6,
+    0xbd33cc3349e47549, 0x16470cff6546b651, 0xca8fd68f6e505dd4, 0x11d270cc51055ea7,
+    0x4419574be3b3c953, 0x1c83e7ad4e6efdd9, 0x0347790982f63aa9, 0x16cfec8aa52597e1,
+    0xcf6c60d468c4fbba, 0x123ff06eea847980, 0xe57a34870e07f92a, 0x1d331a4b10d3f59a,
+    0x512e906c0b399422, 0x175c1508da432ae2, 0xda8ba6bcd5c7a9b5, 0x12b010d3e1cf5581,
+    0x90df712e22d90f87, 0x1de6815302e5559c, 0xda4c5a8b4f140c6c, 0x17eb9aa8cf1dde16,
+    0xaea37ba2a5a9a38a, 0x1322e220a5b17e78, 0x7dd25f6aa2a905a9, 0x1e9e369aa2b59727,
+    0x97db7f888220d154, 0x187e92154ef7ac1f, 0x797c6606ce80a777, 0x139874ddd8c6234c,
+    0x8f2d700ae4010bf1, 0x1f5a549627a36bad, 0x0c2459a25000d65a, 0x191510781fb5efbe,
+    0x701d1481d99a4515, 0x1410d9f9b2f7f2fe, 0xc017439b147b6a77, 0x100d7b2e28c65bfe,
+    0xccf205c4ed9243f2, 0x19af2b7d0e0a2cca, 0x0a5b37d0be0e9cc2, 0x148c22ca71a1bd6f,
+    0x0848f973cb3ee3ce, 0x10701bd527b4978c, 0xda0e5bec78649fb0, 0x1a4cf9550c5425ac,
+    0x7b3eaff060507fc0, 0x150a6110d6a9b7bd, 0x95cbbff380406633, 0x10d51a73deee2c97,
+    0xefac665266cd7052, 0x1aee90b964b04758, 0x2623850eb8a459db, 0x158ba6fab6f36c47,
+    0x1e82d0d893b6ae49, 0x113c85955f29236c, 0xfd9e1af41f8ab075, 0x1b9408eefea838ac,
+    0x97b1af29b2d559f7, 0x16100725988693bd, 0xac8e25baf5777b2c, 0x11a66c1e139edc97,
+    0x7a7d092b2258c513, 0x1c3d79c9b8fe2dbf, 0x61fda0ef4ead6a76, 0x169794a160cb57cc,
+    0xe7fe1a590bbdeec5, 0x1212dd4de7091309, 0xa6635d5b45fcb13a, 0x1ceafbafd80e84dc,
+    0x851c4aaf6b308dc8, 0x172262f3133ed0b0, 0xd0e36ef2bc26d7d4, 0x1281e8c275cbda26,
+    0xb49f17eac6a48c86, 0x1d9ca79d894629d7, 0x2a18dfef0550706b, 0x17b08617a104ee46,
+    0x54e0b3259dd9f389, 0x12f39e794d9d8b6b, 0x87cdeb6f62f65274, 0x1e5297287c2f4578,
+    0xd30b22bf825ea85d, 0x18421286c9bf6ac6, 0x0f3c1bcc684bb9e4, 0x13680ed23aff889f,
+    0x18602c7a4079296d, 0x1f0ce4839198da98, 0x46b356c833942124, 0x18d71d360e13e213,
+    0x388f78a029434db6, 0x13df4a91a4dcb4dc, 0x5a7f2766a86baf8a, 0x1fcbaa82a1612160,
+    0x153285ebb9efbfa2, 0x196fbb9bb44db44d, 0xaa8ed189618c994e, 0x145962e2f6a4903d,
+    0xeed8a7a11ad6e10c, 0x1047824f2bb6d9ca, 0x7e27729b5e249b45, 0x1a0c03b1df8af611,
+    0xfe85f549181d4904, 0x14d6695b193bf80d, 0xcb9e5dd4134aa0d0, 0x10ab877c142ff9a4,
+    0xdf63c9535211014d, 0x1aac0bf9b9e65c3a, 0x191ca10f74da6771, 0x15566ffafb1eb02f,
+    0xadb080d92a4852c1, 0x1111f32f2f4bc025, 0x15e7348eaa0d5134, 0x1b4feb7eb212cd09,
+    0xab1f5d3eee710dc4, 0x15d98932280f0a6d, 0xbc1917658b8da49d, 0x117ad428200c0857,
+    0x2cf4f23c127c3a94, 0x1bf7b9d9cce00d59, 0xf0c3f4fcdb969543, 0x165fc7e170b33de0,
+    0x5a365d9716121103, 0x11e6398126f5cb1a, 0x9056fc24f01ce804, 0x1ca38f350b22de90,
+    0xd9df301d8ce3ecd0, 0x16e93f5da2824ba6, 0xe17f59b13d8323da, 0x125432b14ecea2eb,
+    0x68cbc2b52f38395c, 0x1d53844ee47dd179, 0x53d6355dbf602de3, 0x177603725064a794,
+    0xa9782ab165e68b1c, 0x12c4cf8ea6b6ec76, 0x0f26aab56fd744fa, 0x1e07b27dd78b13f1,
+    0x3f52222abfdf6a62, 0x18062864ac6f4327, 0x65db4e88997f884e, 0x1338205089f29c1f,
+    0x6fc54a7428cc0d4a, 0x1ec033b40fea9365, 0x596aa1f68709a43b, 0x1899c2f673220f84,
+    0xadeee7f86c07b696, 0x13ae3591f5b4d936, 0x497e3ff3e00c5756, 0x1f7d228322baf524,
+    0xd464fff64cd6ac45, 0x1930e868e89590e9, 0x4383fff83d7889d1, 0x14272053ed4473ee,
+    0xcf9cccc69793a174, 0x101f4d0ff1038ff1, 0x7f6147a425b90252, 0x19cbae7fe805b31c,
+    0xcc4dd2e9b7c7350f, 0x14a2f1ffecd15c16, 0x3d0b0f215fd290d9, 0x10825b3323dab012,
+    0x61ab4b689950e7c1, 0x1a6a2b85062ab350, 0x4e22a2ba1440b967, 0x1521bc6a6b555c40,
+    0x0b4ee894dd009453, 0x10e7c9eebc4449cd, 0x1217da87c800ed51, 0x1b0c764ac6d3a948,
+    0xdb46486ca000bdda, 0x15a391d56bdc876c, 0x490506bd4ccd64af, 0x114fa7ddefe39f8a,
+    0xa8080ac87ae23ab1, 0x1bb2a62fe638ff43, 0x5339a239fbe82ef4, 0x162884f31e93ff69,
+    0x75c7b4fb2fecf25d, 0x11ba03f5b20fff87, 0x22d92191e647ea2e, 0x1c5cd322b67fff3f,
+    0xb57a8141850654f2, 0x16b0a8e891ffff65, 0xc4620101373843f5, 0x1226ed86db3332b7,
+    0x3a366801f1f39fee, 0x1d0b15a491eb8459, 0xfb5eb99b27f6198b, 0x173c115074bc69e0,
+    0x2f7efae2865e7ad6, 0x129674405d6387e7, 0xe597f7d0d6fd9156, 0x1dbd86cd6238d971,
+    0x8479930d78cadaab, 0x17cad23de82d7ac1, 0xd06142712d6f1556, 0x1308a831868ac89a,
+    0x4d686a4eaf182222, 0x1e74404f3daada91, 0xa453883ef279b4e8, 0x185d003f6488aeda,
+    0xe9dc6cff28615d87, 0x137d99cc506d58ae, 0xa960ae650d6895a4, 0x1f2f5c7a1a488de4,
+    0xbab3beb73ded4483, 0x18f2b061aea07183, 0x2ef6322c318a9d36, 0x13f559e7bee6c136,
+    0xe4bd1d13827761f0, 0x1feef63f97d79b89, 0x83ca7da9352c4e5a, 0x198bf832dfdfafa1,
+    0x9ca1fe20f756a515, 0x146ff9c24cb2f2e7, 0x4a1b31b3f9121daa, 0x1059949b708f28b9,
+    0x435eb5ecc1b695dd, 0x1a28edc580e50df5, 0x35e55e57015ede4a, 0x14ed8b04671da4c4,
+    0xc4b77eac0118b1d5, 0x10be08d0527e1d69, 0xa12597799b5ab622, 0x1ac9a7b3b7302f0f,
+    0x4db7ac6149155e81, 0x156e1fc2f8f358d9, 0xd7c6238107444b9b, 0x1124e63593f5e0ad,
+    0x593d059b3ed3ac2b, 0x1b6e3d2286563449, 0xe0fd9e15cbdc89bc, 0x15f1ca820511c36d,
+    0xb3fe18116fe3a163, 0x118e3b9b37416924, 0x866359b57fd29bd1, 0x1c16c5c525357507,
+    0xd1e91491330ee30e, 0x16789e3750f790d2, 0x74ba76da8f3f1c0b, 0x11fa182c40c60d75,
+    0xedf72490e531c678, 0x1cc359e067a348bb, 0x8b2c1d40b75b052d, 0x1702ae4d1fb5d3c9,
+    0x6f567dcd5f7c0424, 0x12688b70e62b0fd4, 0x7ef0c94898c66d06, 0x1d74124e3d11b2ed,
+    0x98c0a106e09ebd9f, 0x17900ea4fda7c257, 0x470080d24d4bcae6, 0x12d9a550caec9b79,
+    0xd800ce1d487944a2, 0x1e29088144adc58e, 0x1333d8176d2dd082, 0x1820d39a9d57d13f,
+    0xa8f646792424a6ce, 0x134d76154aaca765, 0x74bd3d8ea03aa47d, 0x1ee25688777aa56f,
+    0x5d64313ee6955064, 0x18b51206c5fbb78c, 0x4ab68dcbebaaa6b7, 0x13c40e6bd1962c70,
+    0x1124161312aaa457, 0x1fa01712e8f0471a, 0xda8344dc0eeee9df, 0x194cdf4253f36c14,
+    0xe2029d7cd8bf2180, 0x143d7f6843292343, 0x4e687dfd7a328133, 0x103132b9cf541c36,
+    0x4a40c9959050ceb8, 0x19e851294bb9c6bd, 0x0833d477a6a70bc6, 0x14b9da876fc7d231,
+    0xa02976c61eec096b, 0x1094aed2bfd30e8d, 0x004257a364acdbdf, 0x1a877e1dffb81749,
+    0xcd01dfb5ea23e319, 0x153931b1996012a0, 0x70ce4c91881cb5ae, 0x10fa8e27ade6754d,
+    0x1ae3adb5a69455e2, 0x1b2a7d0c4970bbaf, 0x7be957c4854377e8, 0x15bb973d078d62f2,
+    0xc987796a0435f987, 0x1162df64060ab58e, 0x75a58f1006bcc271, 0x1bd1656cd67788e4,
+    0xf7b7a5a66bca3527, 0x16411df0ab92d3e9, 0x5fc61e1ebca1c41f, 0x11cdb18d560f0fee,
+    0xffa363646102d365, 0x1c7c4f4889b1b316, 0x32e91c504d9bdc51, 0x16c9d906d48e28df,
+    0x8f20e37371497d0e, 0x123b140576d820b2, 0x7e9b0585820f2e7c, 0x1d2b533bf159cdea,
+    0xcbaf379e01a5beca, 0x1755dc2ff447d7ee, 0x0958f94b348498a1, 0x12ab168cc36cacbf
+};
+
+// 5^i normalized to 125 bits for i in [0, 326), low word first
+const uint64_t _ryu_pow5_split[] = {
+    0x0000000000000000, 0x1000000000000000, 0x0000000000000000, 0x1400000000000000,
+    0x0000000000000000, 0x1900000000000000, 0x0000000000000000, 0x1f40000000000000,
+    0x0000000000000000, 0x1388000000000000, 0x0000000000000000, 0x186a000000000000,
+    0x0000000000000000, 0x1e84800000000000, 0x0000000000000000, 0x1312d00000000000,
+    0x0000000000000000, 0x17d7840000000000, 0x0000000000000000, 0x1dcd650000000000,
+    0x0000000000000000, 0x12a05f2000000000, 0x0000000000000000, 0x174876e800000000,
+    0x0000000000000000, 0x1d1a94a200000000, 0x0000000000000000, 0x12309ce540000000,
+    0x0000000000000000, 0x16bcc41e90000000, 0x0000000000000000, 0x1c6bf52634000000,
+    0x0000000000000000, 0x11c37937e0800000, 0x0000000000000000, 0x16345785d8a00000,
+    0x0000000000000000, 0x1bc16d674ec80000, 0x0000000000000000, 0x1158e460913d0000,
+    0x0000000000000000, 0x15af1d78b58c4000, 0x0000000000000000, 0x1b1ae4d6e2ef5000,
+    0x0000000000000000, 0x10f0cf064dd59200, 0x0000000000000000, 0x152d02c7e14af680,
+    0x0000000000000000, 0x1a784379d99db420, 0x0000000000000000, 0x108b2a2c28029094,
+    0x0000000000000000, 0x14adf4b7320334b9, 0x4000000000000000, 0x19d971e4fe8401e7,
+    0x8800000000000000, 0x1027e72f1f128130, 0xaa00000000000000, 0x1431e0fae6d7217c,
+    0xd480000000000000, 0x193e5939a08ce9db, 0xc9a0000000000000, 0x1f8def8808b02452,
+    0xbe04000000000000, 0x13b8b5b5056e16b3, 0xad85000000000000, 0x18a6e32246c99c60,
+    0xd8e6400000000000, 0x1ed09bead87c0378, 0x878fe80000000000, 0x13426172c74d822b,
+    0x6973e20000000000, 0x1812f9cf7920e2b6, 0x03d0da8000000000, 0x1e17b84357691b64,
+    0x8262889000000000, 0x12ced32a16a1b11e, 0x22fb2ab400000000, 0x178287f49c4a1d66,
+    0xabb9f56100000000, 0x1d6329f1c35ca4bf, 0xcb54395ca0000000, 0x125dfa371a19e6f7,
+    0xbe2947b3c8000000, 0x16f578c4e0a060b5, 0x2db399a0ba000000, 0x1cb2d6f618c878e3,
+    0xfc90400474400000, 0x11efc659cf7d4b8d, 0x7bb4500591500000, 0x166bb7f0435c9e71,
+    0xdaa16406f5a40000, 0x1c06a5ec5433c60d, 0xa8a4de8459868000, 0x118427b3b4a05bc8,
+    0xd2ce16256fe82000, 0x15e531a0a1c872ba, 0x87819baecbe22800, 0x1b5e7e08ca3a8f69,
+    0xf4b1014d3f6d5900, 0x111b0ec57e6499a1, 0x71dd41a08f48af40, 0x1561d276ddfdc00a,
+    0x0e549208b31adb10, 0x1aba4714957d300d, 0x28f4db456ff0c8ea, 0x10b46c6cdd6e3e08,
+    0x33321216cbecfb24, 0x14e1878814c9cd8a, 0xbffe969c7ee839ed, 0x1a19e96a19fc40ec,
+    0xf7ff1e21cf512434, 0x105031e2503da893, 0xf5fee5aa43256d41, 0x14643e5ae44d12b8,
+    0x337e9f14d3eec892, 0x197d4df19d605767, 0x005e46da08ea7ab6, 0x1fdca16e04b86d41,
+    0xa03aec4845928cb2, 0x13e9e4e4c2f34448, 0xc849a75a56f72fde, 0x18e45e1df3b0155a,
+    0x7a5c1130ecb4fbd6, 0x1f1d75a5709c1ab1, 0xec798abe93f11d65, 0x13726987666190ae,
+    0xa797ed6e38ed64bf, 0x184f03e93ff9f4da, 0x517de8c9c728bdef, 0x1e62c4e38ff87211,
+    0xd2eeb17e1c7976b5, 0x12fdbb0e39fb474a, 0x87aa5ddda397d462, 0x17bd29d1c87a191d,
+    0xe994f5550c7dc97b, 0x1dac74463a989f64, 0x11fd195527ce9ded, 0x128bc8abe49f639f,
+    0xd67c5faa71c24568, 0x172ebad6ddc73c86, 0x8c1b77950e32d6c2, 0x1cfa698c95390ba8,
+    0x57912abd28dfc639, 0x121c81f7dd43a749, 0xad75756c7317b7c8, 0x16a3a275d494911b,
+    0x98d2d2c78fdda5ba, 0x1c4c8b1349b9b562, 0x9f83c3bcb9ea8794, 0x11afd6ec0e14115d,
+    0x0764b4abe8652979, 0x161bcca7119915b5, 0x493de1d6e27e73d7, 0x1ba2bfd0d5ff5b22,
+    0x6dc6ad264d8f0866, 0x1145b7e285bf98f5, 0xc938586fe0f2ca80, 0x159725db272f7f32,
+    0x7b866e8bd92f7d20, 0x1afcef51f0fb5eff, 0xad34051767bdae34, 0x10de1593369d1b5f,
+    0x9881065d41ad19c1, 0x15159af804446237, 0x7ea147f492186032, 0x1a5b01b605557ac5,
+    0x6f24ccf8db4f3c1f, 0x1078e111c3556cbb, 0x4aee003712230b27, 0x14971956342ac7ea,
+    0xdda98044d6abcdf0, 0x19bcdfabc13579e4, 0x0a89f02b062b60b6, 0x10160bcb58c16c2f,
+    0xcd2c6c35c7b638e4, 0x141b8ebe2ef1c73a, 0x8077874339a3c71d, 0x1922726dbaae3909,
+    0xe0956914080cb8e4, 0x1f6b0f092959c74b, 0x6c5d61ac8507f38e, 0x13a2e965b9d81c8f,
+    0x4774ba17a649f072, 0x188ba3bf284e23b3, 0x1951e89d8fdc6c8f, 0x1eae8caef261aca0,
+    0x0fd3316279e9c3d9, 0x132d17ed577d0be4, 0x13c7fdbb186434cf, 0x17f85de8ad5c4edd,
+    0x58b9fd29de7d4203, 0x1df67562d8b36294, 0xb7743e3a2b0e4942, 0x12ba095dc7701d9c,
+    0xe5514dc8b5d1db92, 0x17688bb5394c2503, 0xdea5a13ae3465277, 0x1d42aea2879f2e44,
+    0x0b2784c4ce0bf38a, 0x1249ad2594c37ceb, 0xcdf165f6018ef06d, 0x16dc186ef9f45c25,
+    0x416dbf7381f2ac88, 0x1c931e8ab871732f, 0x88e497a83137abd5, 0x11dbf316b346e7fd,
+    0xeb1dbd923d8596ca, 0x1652efdc6018a1fc, 0x25e52cf6cce6fc7d, 0x1be7abd3781eca7c,
+    0x97af3c1a40105dce, 0x1170cb642b133e8d, 0xfd9b0b20d0147542, 0x15ccfe3d35d80e30,
+    0x3d01cde904199292, 0x1b403dcc834e11bd, 0x462120b1a28ffb9b, 0x1108269fd210cb16,
+    0xd7a968de0b33fa82, 0x154a3047c694fddb, 0xcd93c3158e00f923, 0x1a9cbc59b83a3d52,
+    0xc07c59ed78c09bb6, 0x10a1f5b813246653, 0xb09b7068d6f0c2a3, 0x14ca732617ed7fe8,
+    0xdcc24c830cacf34c, 0x19fd0fef9de8dfe2, 0xc9f96fd1e7ec180f, 0x103e29f5c2b18bed,
+    0x3c77cbc661e71e13, 0x144db473335deee9, 0x8b95beb7fa60e598, 0x1961219000356aa3,
+    0x6e7b2e65f8f91efe, 0x1fb969f40042c54c, 0xc50cfcffbb9bb35f, 0x13d3e2388029bb4f,
+    0xb6503c3faa82a037, 0x18c8dac6a0342a23, 0xa3e44b4f95234844, 0x1efb1178484134ac,
+    0xe66eaf11bd360d2b, 0x135ceaeb2d28c0eb, 0xe00a5ad62c839075, 0x183425a5f872f126,
+    0x980cf18bb7a47493, 0x1e412f0f768fad70, 0x5f0816f752c6c8dc, 0x12e8bd69aa19cc66,
+    0xf6ca1cb527787b13, 0x17a2ecc414a03f7f, 0xf47ca3e2715699d7, 0x1d8ba7f519c84f5f,
+    0xf8cde66d86d62026, 0x127748f9301d319b, 0xf7016008e88ba830, 0x17151b377c247e02,
+    0xb4c1b80b22ae923c, 0x1cda62055b2d9d83, 0x50f91306f5ad1b65, 0x12087d4358fc8272,
+    0xe53757c8b318623f, 0x168a9c942f3ba30e, 0x9e852dbadfde7acf, 0x1c2d43b93b0a8bd2,
+    0xa3133c94cbeb0cc1, 0x119c4a53c4e69763, 0x8bd80bb9fee5cff1, 0x16035ce8b6203d3c,
+    0xaece0ea87e9f43ee, 0x1b843422e3a84c8b, 0x4d40c9294f238a75, 0x1132a095ce492fd7,
+    0x2090fb73a2ec6d12, 0x157f48bb41db7bcd, 0x68b53a508ba78856, 0x1adf1aea12525ac0,
+    0x417144725748b536, 0x10cb70d24b7378b8, 0x51cd958eed1ae283, 0x14fe4d06de5056e6,
+    0xe640faf2a8619b24, 0x1a3de04895e46c9f, 0xefe89cd7a93d00f7, 0x1066ac2d5daec3e3,
+    0xebe2c40d938c4134, 0x14805738b51a74dc, 0x26db7510f86f5181, 0x19a06d06e2611214,
+    0x9849292a9b4592f1, 0x100444244d7cab4c, 0xbe5b73754216f7ad, 0x1405552d60dbd61f,
+    0xadf25052929cb598, 0x1906aa78b912cba7, 0x996ee4673743e2ff, 0x1f485516e7577e91,
+    0xffe54ec0828a6ddf, 0x138d352e5096af1a, 0xbfdea270a32d0957, 0x18708279e4bc5ae1,
+    0x2fd64b0ccbf84bad, 0x1e8ca3185deb719a, 0x5de5eee7ff7b2f4c, 0x1317e5ef3ab32700,
+    0x755f6aa1ff59fb1f, 0x17dddf6b095ff0c0, 0x92b7454a7f3079e7, 0x1dd55745cbb7ecf0,
+    0x5bb28b4e8f7e4c30, 0x12a5568b9f52f416, 0xf29f2e22335ddf3c, 0x174eac2e8727b11b,
+    0xef46f9aac035570b, 0x1d22573a28f19d62, 0xd58c5c0ab8215667, 0x123576845997025d,
+    0x4aef730d6629ac01, 0x16c2d4256ffcc2f5, 0x9dab4fd0bfb41701, 0x1c73892ecbfbf3b2,
+    0xa28b11e277d08e60, 0x11c835bd3f7d784f, 0x8b2dd65b15c4b1f9, 0x163a432c8f5cd663,
+    0x6df94bf1db35de77, 0x1bc8d3f7b3340bfc, 0xc4bbcf772901ab0a, 0x115d847ad000877d,
+    0x35eac354f34215cd, 0x15b4e5998400a95d, 0x8365742a30129b40, 0x1b221effe500d3b4,
+    0xd21f689a5e0ba108, 0x10f5535fef208450, 0x06a742c0f58e894a, 0x1532a837eae8a565,
+    0x4851137132f22b9d, 0x1a7f5245e5a2cebe, 0xed32ac26bfd75b42, 0x108f936baf85c136,
+    0xa87f57306fcd3212, 0x14b378469b673184, 0xd29f2cfc8bc07e97, 0x19e056584240fde5,
+    0xa3a37c1dd7584f1e, 0x102c35f729689eaf, 0x8c8c5b254d2e62e6, 0x14374374f3c2c65b,
+    0x6faf71eea079fb9f, 0x1945145230b377f2, 0x0b9b4e6a48987a87, 0x1f965966bce055ef,
+    0x674111026d5f4c94, 0x13bdf7e0360c35b5, 0xc111554308b71fba, 0x18ad75d8438f4322,
+    0x7155aa93cae4e7a8, 0x1ed8d34e547313eb, 0x26d58a9c5ecf10c9, 0x13478410f4c7ec73,
+    0xf08aed437682d4fb, 0x1819651531f9e78f, 0xecada89454238a3a, 0x1e1fbe5a7e786173,
+    0x73ec895cb4963664, 0x12d3d6f88f0b3ce8, 0x90e7abb3e1bbc3fd, 0x1788ccb6b2ce0c22,
+    0x352196a0da2ab4fd, 0x1d6affe45f818f2b, 0x0134fe24885ab11e, 0x1262dfeebbb0f97b,
+    0xc1823dadaa715d65, 0x16fb97ea6a9d37d9, 0x31e2cd19150db4bf, 0x1cba7de5054485d0,
+    0x1f2dc02fad2890f7, 0x11f48eaf234ad3a2, 0xa6f9303b9872b535, 0x1671b25aec1d888a,
+    0x50b77c4a7e8f6282, 0x1c0e1ef1a724eaad, 0x5272adae8f199d91, 0x1188d357087712ac,
+    0x670f591a32e004f6, 0x15eb082cca94d757, 0x40d32f60bf980633, 0x1b65ca37fd3a0d2d,
+    0x4883fd9c77bf03e0, 0x111f9e62fe44483c, 0x5aa4fd0395aec4d8, 0x156785fbbdd55a4b,
+    0x314e3c447b1a760e, 0x1ac1677aad4ab0de, 0xded0e5aaccf089c9, 0x10b8e0acac4eae8a,
+    0x96851f15802cac3b, 0x14e718d7d7625a2d, 0xfc2666dae037d74a, 0x1a20df0dcd3af0b8,
+    0x9d980048cc22e68e, 0x10548b68a044d673, 0x84fe005aff2ba032, 0x1469ae42c8560c10,
+    0xa63d8071bef6883e, 0x198419d37a6b8f14, 0xcfcce08e2eb42a4e, 0x1fe52048590672d9,
+    0x21e00c58dd309a70, 0x13ef342d37a407c8, 0x2a580f6f147cc10d, 0x18eb0138858d09ba,
+    0xb4ee134ad99bf150, 0x1f25c186a6f04c28, 0x7114cc0ec80176d2, 0x137798f428562f99,
+    0xcd59ff127a01d486, 0x18557f31326bbb7f, 0xc0b07ed7188249a8, 0x1e6adefd7f06aa5f,
+    0xd86e4f466f516e09, 0x1302cb5e6f642a7b, 0xce89e3180b25c98b, 0x17c37e360b3d351a,
+    0x822c5bde0def3bee, 0x1db45dc38e0c8261, 0xf15bb96ac8b58575, 0x1290ba9a38c7d17c,
+    0x2db2a7c57ae2e6d2, 0x1734e940c6f9c5dc, 0x391f51b6d99ba086, 0x1d022390f8b83753,
+    0x03b3931248014454, 0x1221563a9b732294, 0x04a077d6da019569, 0x16a9abc9424feb39,
+    0x45c895cc9081fac3, 0x1c5416bb92e3e607, 0x8b9d5d9fda513cba, 0x11b48e353bce6fc4,
+    0xae84b507d0e58be8, 0x1621b1c28ac20bb5, 0x1a25e249c51eeee3, 0x1baa1e332d728ea3,
+    0xf057ad6e1b33554d, 0x114a52dffc679925, 0x6c6d98c9a2002aa1, 0x159ce797fb817f6f,
+    0x4788fefc0a803549, 0x1b04217dfa61df4b, 0x0cb59f5d8690214e, 0x10e294eebc7d2b8f,
+    0xcfe30734e83429a1, 0x151b3a2a6b9c7672, 0x83dbc9022241340a, 0x1a6208b50683940f,
+    0xb2695da15568c086, 0x107d457124123c89, 0x1f03b509aac2f0a7, 0x149c96cd6d16cbac,
+    0x26c4a24c1573acd1, 0x19c3bc80c85c7e97, 0x783ae56f8d684c03, 0x101a55d07d39cf1e,
+    0x16499ecb70c25f03, 0x1420eb449c8842e6, 0x9bdc067e4cf2f6c4, 0x19292615c3aa539f,
+    0x82d3081de02fb476, 0x1f736f9b3494e887, 0xb1c3e512ac1dd0c9, 0x13a825c100dd1154,
+    0xde34de57572544fc, 0x18922f31411455a9, 0x55c215ed2cee963b, 0x1eb6bafd91596b14,
+    0xb5994db43c151de5, 0x133234de7ad7e2ec, 0xe2ffa1214b1a655e, 0x17fec216198ddba7,
+    0xdbbf89699de0feb6, 0x1dfe729b9ff15291, 0x2957b5e202ac9f31, 0x12bf07a143f6d39b,
+    0xf3ada35a8357c6fe, 0x176ec98994f48881, 0x70990c31242db8bd, 0x1d4a7bebfa31aaa2,
+    0x865fa79eb69c9376, 0x124e8d737c5f0aa5, 0xe7f791866443b854, 0x16e230d05b76cd4e,
+    0xa1f575e7fd54a669, 0x1c9abd04725480a2, 0xa53969b0fe54e801, 0x11e0b622c774d065,
+    0x0e87c41d3dea2202, 0x1658e3ab7952047f, 0xd229b5248d64aa82, 0x1bef1c9657a6859e,
+    0x435a1136d85eea91, 0x117571ddf6c81383, 0x143095848e76a536, 0x15d2ce55747a1864,
+    0x193cbae5b2144e83, 0x1b4781ead1989e7d, 0x2fc5f4cf8f4cb112, 0x110cb132c2ff630e,
+    0xbbb77203731fdd56, 0x154fdd7f73bf3bd1, 0x2aa54e844fe7d4ac, 0x1aa3d4df50af0ac6,
+    0xdaa75112b1f0e4eb, 0x10a6650b926d66bb, 0xd15125575e6d1e26, 0x14cffe4e7708c06a,
+    0x85a56ead360865b0, 0x1a03fde214caf085, 0x7387652c41c53f8e, 0x10427ead4cfed653,
+    0x50693e7752368f71, 0x14531e58a03e8be8, 0x64838e1526c4334e, 0x1967e5eec84e2ee2,
+    0xfda4719a70754022, 0x1fc1df6a7a61ba9a, 0xde86c70086494815, 0x13d92ba28c7d14a0,
+    0x162878c0a7db9a1a, 0x18cf768b2f9c59c9, 0x5bb296f0d1d280a1, 0x1f03542dfb83703b,
+    0x194f9e5683239064, 0x1362149cbd322625, 0x5fa385ec23ec747e, 0x183a99c3ec7eafae,
+    0xf78c67672ce7919d, 0x1e494034e79e5b99, 0x3ab7c0a07c10bb02, 0x12edc82110c2f940,
+    0x4965b0c89b14e9c3, 0x17a93a2954f3b790, 0x5bbf1cfac1da2433, 0x1d9388b3aa30a574,
+    0xb957721cb92856a0, 0x127c35704a5e6768, 0xe7ad4ea3e7726c48, 0x171b42cc5cf60142,
+    0xa198a24ce14f075a, 0x1ce2137f74338193, 0x44ff65700cd16498, 0x120d4c2fa8a030fc,
+    0x563f3ecc1005bdbe, 0x16909f3b92c83d3b, 0x2bcf0e7f14072d2e, 0x1c34c70a777a4c8a,
+    0x5b61690f6c847c3d, 0x11a0fc668aac6fd6, 0xf239c35347a59b4c, 0x16093b802d578bcb,
+    0xeec83428198f021f, 0x1b8b8a6038ad6ebe, 0x553d20990ff96153, 0x1137367c236c6537,
+    0x2a8c68bf53f7b9a8, 0x1585041b2c477e85, 0x752f82ef28f5a812, 0x1ae64521f7595e26,
+    0x093db1d57999890b, 0x10cfeb353a97dad8, 0x0b8d1e4ad7ffeb4e, 0x1503e602893dd18e,
+    0x8e7065dd8dffe622, 0x1a44df832b8d45f1, 0xf9063faa78bfefd5, 0x106b0bb1fb384bb6,
+    0xb747cf9516efebca, 0x1485ce9e7a065ea4, 0xe519c37a5cabe6bd, 0x19a742461887f64d,
+    0xaf301a2c79eb7036, 0x1008896bcf54f9f0, 0xdafc20b798664c43, 0x140aabc6c32a386c,
+    0x11bb28e57e7fdf54, 0x190d56b873f4c688, 0x1629f31ede1fd72a, 0x1f50ac6690f1f82a,
+    0x4dda37f34ad3e67a, 0x13926bc01a973b1a, 0xe150c5f01d88e019, 0x187706b0213d09e0,
+    0x19a4f76c24eb181f, 0x1e94c85c298c4c59, 0xb0071aa39712ef13, 0x131cfd3999f7afb7,
+    0x9c08e14c7cd7aad8, 0x17e43c8800759ba5, 0x030b199f9c0d958e, 0x1ddd4baa0093028f,
+    0x61e6f003c1887d79, 0x12aa4f4a405be199, 0xba60ac04b1ea9cd7, 0x1754e31cd072d9ff,
+    0xa8f8d705de65440d, 0x1d2a1be4048f907f, 0xc99b8663aaff4a88, 0x123a516e82d9ba4f,
+    0xbc0267fc95bf1d2a, 0x16c8e5ca239028e3, 0xab0301fbbb2ee474, 0x1c7b1f3cac74331c,
+    0xeae1e13d54fd4ec9, 0x11ccf385ebc89ff1, 0x659a598caa3ca27b, 0x1640306766bac7ee,
+    0xff00efefd4cbcb1a, 0x1bd03c81406979e9, 0x3f6095f5e4ff5ef0, 0x116225d0c841ec32,
+    0xcf38bb735e3f36ac, 0x15baaf44fa52673e, 0x8306ea5035cf0457, 0x1b295b1638e7010e,
+    0x11e4527221a162b6, 0x10f9d8ede39060a9, 0x565d670eaa09bb64, 0x15384f295c7478d3,
+    0x2bf4c0d2548c2a3d, 0x1a8662f3b3919708, 0x1b78f88374d79a66, 0x1093fdd8503afe65,
+    0x625736a4520d8100, 0x14b8fd4e6449bdfe, 0xfaed044d6690e140, 0x19e73ca1fd5c2d7d,
+    0xbcd422b0601a8cc8, 0x103085e53e599c6e, 0x6c092b5c78212ffa, 0x143ca75e8df0038a,
+    0x070b763396297bf8, 0x194bd136316c046d, 0x48ce53c07bb3daf6, 0x1f9ec583bdc70588,
+    0x2d80f4584d5068da, 0x13c33b72569c6375, 0x78e1316e60a48310, 0x18b40a4eec437c52
+};
+
+int _ryu_pow5_bits(int e)
+{
+    return (int)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+uint32_t _ryu_log10_pow2(int e)
+{
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+uint32_t _ryu_log10_pow5(int e)
+{
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+bool _ryu_multiple_of_pow5(uint64_t value, uint32_t p)
+{
+    uint32_t count = 0;
+    for (; value % 5 == 0; value /= 5)
+    {
+        count++;
+    }
+
+    return count >= p;
+}
+
+bool _ryu_multiple_of_pow2(uint64_t value, uint32_t p)
+{
+    return (value & (((uint64_t)1 << p) - 1)) == 0;
+}
+
+uint64_t _ryu_mul_shift(uint64_t m, const uint64_t *mul, int j)
+{
+    uint64_t high1;
+    uint64_t low1 = _full_multiplication(m, mul[1], &high1);
+    uint64_t high0;
+    _full_multiplication(m, mul[0], &high0);
+
+    uint64_t sum = high0 + low1;
+    if (sum < high0)
+    {
+        high1++;
+    }
+
+    int shift = j - 64;
+    return (high1 << (64 - shift)) | (sum >> shift);
+}
+
+// Shortest decimal digits and exponent with digits * 10^exponent == value
+void _ryu(uint64_t ieee_mantissa, uint32_t ieee_exponent, uint64_t *digits, int *exponent)
+{
+    int e2;
+    uint64_t m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = (int)ieee_exponent - 1023 - 52 - 2;
+        m2 = ((uint64_t)1 << 52) | ieee_mantissa;
+    }
+
+    bool accept_bounds = (m2 & 1) == 0;
+
+    // The interval of decimals that round to this double is [4m - 1 - mm_shift, 4m + 2] * 2^e2
+    uint64_t mv = 4 * m2;
+    uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+
+    if (e2 >= 0)
+    {
+        uint32_t q = _ryu_log10_pow2(e2) - (e2 > 3);
+        e10 = (int)q;
+        int k = 125 + _ryu_pow5_bits(q) - 1;
+        int i = -e2 + (int)q + k;
+        const uint64_t *mul = _ryu_pow5_inv_split + 2 * q;
+
+        vr = _ryu_mul_shift(mv, mul, i);
+        vp = _ryu_mul_shift(mv + 2, mul, i);
+        vm = _ryu_mul_shift(mv - 1 - mm_shift, mul, i);
+
+        if (q <= 21)
+        {
+            if (mv % 5 == 0)
+            {
+                vr_trailing_zeros = _ryu_multiple_of_pow5(mv, q);
+            }
+            else if (accept_bounds)
+            {
+                vm_trailing_zeros = _ryu_multiple_of_pow5(mv - 1 - mm_shift, q);
+            }
+            else
+            {
+                vp -= _ryu_multiple_of_pow5(mv + 2, q);
+            }
+        }
+    }
+    else
+    {
+        uint32_t q = _ryu_log10_pow5(-e2) - (-e2 > 1);
+        e10 = (int)q + e2;
+        int i = -e2 - (int)q;
+        int k = _ryu_pow5_bits(i) - 125;
+        int j = (int)q - k;
+        const uint64_t *mul = _ryu_pow5_split + 2 * i;
+
+        vr = _ryu_mul_shift(mv, mul, j);
+        vp = _ryu_mul_shift(mv + 2, mul, j);
+        vm = _ryu_mul_shift(mv - 1 - mm_shift, mul, j);
+
+        if (q <= 1)
+        {
+            vr_trailing_zeros = true;
+            if (accept_bounds)
+            {
+                vm_trailing_zeros = mm_shift == 1;
+            }
+            else
+            {
+                vp--;
+            }
+        }
+        else if (q < 63)
+        {
+            vr_trailing_zeros = _ryu_multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Remove digits while the interval still holds a shorter decimal
+    int removed = 0;
+    uint32_t last_removed = 0;
+    uint64_t output;
+
+    if (vm_trailing_zeros || vr_trailing_zeros)
+    {
+        for (; vp / 10 > vm / 10; removed++)
+        {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = (uint32_t)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+
+        if (vm_trailing_zeros)
+        {
+            for (; vm % 10 == 0; removed++)
+            {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = (uint32_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+            }
+        }
+
+        // An exact tie rounds to even
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0)
+        {
+            last_removed = 4;
+        }
+
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    }
+    else
+    {
+        bool round_up = false;
+
+        if (vp / 100 > vm / 100)
+        {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+
+        for (; vp / 10 > vm / 10; removed++)
+        {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+
+        output = vr + (vr == vm || round_up);
+    }
+
+    *digits = output;
+    *exponent = e10 + removed;
+}
+
+char *_format_integer(uint64_t x, char *out)
+{
+    char buf[20];
+    char *p = buf + sizeof(buf);
+
+    do
+    {
+        *--p = (char)('0' + x % 10);
+        x /= 10;
+    } while (x != 0);
+
+    size_t length = buf + sizeof(buf) - p;
+    memcpy(out, p, length);
+    return out + length;
+}
+
+// Writes the shortest JSON representation of x to out, which must have room
+// for 25 characters, and returns the end of the written text
+char *_format_number(double x, char *out)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+
+    uint64_t ieee_mantissa = bits & (((uint64_t)1 << 52) - 1);
+    uint32_t ieee_exponent = (uint32_t)(bits >> 52) & 0x7FF;
+
+    // JSON has no representation for infinities or NaN
+    if (ieee_exponent == 0x7FF)
+    {
+        memcpy(out, "null", 4);
+        return out + 4;
+    }
+
+    if (bits >> 63)
+    {
+        *out++ = '-';
+    }
+
+    if (ieee_exponent == 0 && ieee_mantissa == 0)
+    {
+        *out++ = '0';
+        return out;
+    }
+
+    double magnitude = x < 0 ? -x : x;
+    if (magnitude < 9007199254740992.0 && magnitude == (double)(uint64_t)magnitude)
+    {
+        return _format_integer((uint64_t)magnitude, out);
+    }
+
+    uint64_t digits;
+    int exponent;
+    _ryu(ieee_mantissa, ieee_exponent, &digits, &exponent);
+
+    char buf[20];
+    char *end = _format_integer(digits, buf);
+    int length = (int)(end - buf);
+
+    // Position of the decimal point relative to the first digit
+    int point = length + exponent;
+
+    if (exponent >= 0 && point <= 21)
+    {
+        memcpy(out, buf, length);
+        memset(out + length, '0', exponent);
+        return out + point;
+    }
+
+    if (point > 0 && point <= 21)
+    {
+        memcpy(out, buf, point);
+        out[point] = '.';
+        memcpy(out + point + 1, buf + point, length - point);
+        return out + length + 1;
+    }
+
+    if (point > -6 && point <= 0)
+    {
+        out[0] = '0';
+        out[1] = '.';
+        memset(out + 2, '0', -point);
+        memcpy(out + 2 - point, buf, length);
+        return out + 2 - point + length;
+    }
+
+    *out++ = buf[0];
+    if (length > 1)
+    {
+        *out++ = '.';
+        memcpy(out, buf + 1, length - 1);
+        out += length - 1;
+    }
+
+    *out++ = 'e';
+    if (point - 1 < 0)
+    {
+        *out++ = '-';
+    }
+
+    return _format_integer(point - 1 < 0 ? 1 - point : point - 1, out);
+}
+
+/*
+ * Parsing of primitive types
+ */
+// Reads the byte at s, or a NUL at the end of the input
+char _peek(const char *s, const char *end)
+{
+    return s < end ? *s : '\0';
+}
+
+bool _is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool _available(const char *s, const char *end, size_t length)
+{
+    return (uintptr_t)end - (uintptr_t)s >= length;
+}
+
+const char *__consume_phrase(const char *s, const char *end, const char *phrase, int line)
+{
+    for (const char *p = phrase; *p; p++, s++)
+    {
+        if (*p != _peek(s, end))
+        {
+            throw JSON::DecodeException(line);
+        }
+    }
+
+    return s;
+}
+#define _CONSUME_NULL(s, end, line) (__consume_phrase(s, end, "null", line))
+#define _CONSUME_TRUE(s, end, line) (__consume_phrase(s, end, "true", line))
+#define _CONSUME_FALSE(s, end, line) (__consume_phrase(s, end, "false", line))
+
+const char *_consume_number(const char *s, const char *end, double *x, int line)
+{
+    bool negative = _peek(s, end) == '-';
+    if (negative)
+    {
+        s++;
+    }
+
+    const char *digits = s;
+    uint64_t w = 0;
+    int significant = 0;
+    int64_t exponent = 0;
+    bool truncated = false;
+
+    // Integer part, without leading zeros
+    if (_peek(s, end) == '0')
+    {
+        s++;
+    }
+    else if (_is_digit(_peek(s, end)))
+    {
+        for (; _is_digit(_peek(s, end)); s++)
+        {
+            if (significant < 19)
+            {
+                w = w * 10 + (*s - '0');
+                significant++;
+            }
+            else
+            {
+                truncated |= *s != '0';
+                exponent++;
+            }
+        }
+    }
+    else
+    {
+        throw JSON::DecodeException(line);
+    }
+
+    // Fraction
+    if (_peek(s, end) == '.')
+    {
+        if (!_is_digit(_peek(++s, end)))
+        {
+            throw JSON::DecodeException(line);
+        }
+
+        for (; _is_digit(_peek(s, end)); s++)
+        {
+            if (w == 0 && *s == '0')
+            {
+                exponent--;
+            }
+            else if (significant < 19)
+            {
+                w = w * 10 + (*s - '0');
+                significant++;
+                exponent--;
+            }
+            else
+            {
+                truncated |= *s != '0';
+            }
+        }
+    }
+
+    const char *digits_end = s;
+
+    // Exponent
+    int64_t explicit_exponent = 0;
+    if (_peek(s, end) == 'e' || _peek(s, end) == 'E')
+    {
+        bool exponent_negative = _peek(++s, end) == '-';
+        if (_peek(s, end) == '-' || _peek(s, end) == '+')
+        {
+            s++;
+        }
+
+        if (!_is_digit(_peek(s, end)))
+        {
+            throw JSON::DecodeException(line);
+        }
+
+        for (; _is_digit(_peek(s, end)); s++)
+        {
+            if (explicit_exponent < 100000)
+            {
+                explicit_exponent = explicit_exponent * 10 + (*s - '0');
+            }
+        }
+
+        if (exponent_negative)
+        {
+            explicit_exponent = -explicit_exponent;
+        }
+    }
+
+    exponent += explicit_exponent;
+
+    if (w == 0)
+    {
+        *x = negative ? -0.0 : 0.0;
+        return s;
+    }
+
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1)
+    // Both operands are exact, so one IEEE operation rounds correctly
+    if (!truncated && exponent >= -22 && exponent <= 22 && w <= ((uint64_t)1 << 53))
+    {
+        double d = (double)w;
+        d = exponent < 0 ? d / _exact_powers_of_ten[-exponent] : d * _exact_powers_of_ten[exponent];
+        *x = negative ? -d : d;
+        return s;
+    }
+#endif
+
+    uint64_t mantissa;
+    int power2;
+    _eisel_lemire(exponent, w, &mantissa, &power2);
+
+    if (truncated)
+    {
+        // The true value lies between w and w + 1 scaled by the same power
+        uint64_t upper_mantissa;
+        int upper_power2;
+        _eisel_lemire(exponent, w + 1, &upper_mantissa, &upper_power2);
+
+        if (mantissa != upper_mantissa || power2 != upper_power2)
+        {
+            *x = _decimal_to_double_exact(digits, digits_end, explicit_exponent, negative);
+            return s;
+        }
+    }
+
+    *x = _make_double(mantissa, power2, negative);
+    return s;
+}
+
+unsigned int _consume_hex4(const char *s, const char *end, int line)
+{
+    unsigned int t = 0;
+
+    if (!_available(s, end, 4))
+    {
+        throw JSON::DecodeException(line);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        char c = s[i];
+        if (c >= '0' && c <= '9')
+        {
+            t = (t << 4) | (c - '0');
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            t = (t << 4) | (c - 'A' + 10);
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            t = (t << 4) | (c - 'a' + 10);
+        }
+        else
+        {
+            throw JSON::DecodeException(line);
+        }
+    }
+
+    return t;
+}
+
+void _append_utf8(std::string *p, unsigned int t)
+{
+    if (t < 0x80)
+    {
+        *p += (char)t;
+    }
+    else if (t < 0x800)
+    {
+        *p += (char)(0xC0 | (t >> 6));
+        *p += (char)(0x80 | (t & 0x3F));
+    }
+    else if (t < 0x10000)
+    {
+        *p += (char)(0xE0 | (t >> 12));
+        *p += (char)(0x80 | ((t >> 6) & 0x3F));
+        *p += (char)(0x80 | (t & 0x3F));
+    }
+    else
+    {
+        *p += (char)(0xF0 | (t >> 18));
+        *p += (char)(0x80 | ((t >> 12) & 0x3F));
+        *p += (char)(0x80 | ((t >> 6) & 0x3F));
+        *p += (char)(0x80 | (t & 0x3F));
+    }
+}
+
+const char *_consume_string(const char *s, const char *end, std::string *p, int line)
+{
+    p->clear();
+
+    for (s++;;)
+    {
+        // Copy everything up to the next quote, backslash or control byte
+        const char *run = _kernels().scan_string(s, end);
+        p->append(s, run - s);
+        s = run;
+
+        if (s == end || *s == '\0')
+        {
+            throw JSON::DecodeException(line);
+        }
+
+        if (*s == '"')
+        {
+            return s + 1;
+        }
+
+        if (*s != '\\')
+        {
+            throw JSON::InvalidControlCharacterException();
+        }
+
+        switch (_peek(++s, end))
+        {
+        case '"':
+        case '\\':
+        case '/':
+            *p += *(s++);
+            break;
+        case 'b':
+            *p += '\b';
+            s++;
+            break;
+        case 'f':
+            *p += '\f';
+            s++;
+            break;
+        case 'n':
+            *p += '\n';
+            s++;
+            break;
+        case 'r':
+            *p += '\r';
+            s++;
+            break;
+        case 't':
+            *p += '\t';
+            s++;
+            break;
+        case 'u':
+        {
+            unsigned int t = _consume_hex4(s + 1, end, line);
+            s += 5;
+
+            if (t < 0x20)
+            {
+                throw JSON::InvalidControlCharacterException();
+            }
+
+            // Combine a surrogate pair into a single code point
+            if (t >= 0xD800 && t <= 0xDBFF && _available(s, end, 6) && s[0] == '\\' && s[1] == 'u')
+            {
+                unsigned int u = _consume_hex4(s + 2, end, line);
+                if (u >= 0xDC00 && u <= 0xDFFF)
+                {
+                    t = 0x10000 + ((t - 0xD800) << 10) + (u - 0xDC00);
+                    s += 6;
+                }
+            }
+
+            _append_utf8(p, t);
+            break;
+        }
+        default:
+            throw JSON::DecodeException(line);
+        }
+    }
+}
+
+const char *_consume_whitespace(const char *s, const char *end, int *line)
+{
+    // Most runs between tokens are empty or a single space
+    if (!_is_whitespace(_peek(s, end)))
+    {
+        return s;
+    }
+
+    if (!_is_whitespace(_peek(s + 1, end)))
+    {
+        if (*s == '\n')
+        {
+            *line += 1;
+        }
+
+        return s + 1;
+    }
+
+    return _kernels().scan_whitespace(s, end, line);
+}
+
+// Skips a nested object or array by matching brackets. Everything else
+// inside it is validated when it is materialized.
+const char *_skip_container(const char *s, const char *end, int *line)
+{
+    size_t depth = 0;
+
+    do
+    {
+        switch (_peek(s, end))
+        {
+        case '{':
+        case '[':
+            depth++;
+            s++;
+            break;
+        case '}':
+        case ']':
+            depth--;
+            s++;
+            break;
+        case '"':
+            for (s = _kernels().scan_string(s + 1, end); _peek(s, end) != '"'; s = _kernels().scan_string(s, end))
+            {
+                if (_peek(s, end) == '\0')
+                {
+                    throw JSON::DecodeException(*line);
+                }
+
+                s += (*s == '\\' && _peek(s + 1, end) != '\0') ? 2 : 1;
+            }
+            s++;
+            break;
+        case '\n':
+            *line += 1;
+            s++;
+            break;
+        case '\0':
+            throw JSON::DecodeException(*line);
+        default:
+            s++;
+            break;
+        }
+    } while (depth != 0);
+
+    return s;
+}
+
+// Scans the array at s up to its closing bracket, which is returned. Along
+// the way it records the position just past the first top-level comma
+// after every multiple of 1 / parts of the input, and the line there.
+const char *_split_array(const char *s, const char *end, int *line, size_t parts, std::vector<const char *> *splits, std::vector<int> *lines)
+{
+    size_t step = (end - s) / parts;
+    const char *next = s + step;
+    size_t depth = 0;
+
+    for (s++;; s++)
+    {
+        switch (_peek(s, end))
+        {
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            if (depth == 0)
+            {
+                return s;
+            }
+            depth--;
+            break;
+        case ',':
+            if (depth == 0 && s >= next)
+            {
+                splits->push_back(s + 1);
+                lines->push_back(*line);
+                next = s + step;
+            }
+            break;
+        case '"':
+            for (s = _kernels().scan_string(s + 1, end); _peek(s, end) != '"'; s = _kernels().scan_string(s, end))
+            {
+                if (_peek(s, end) == '\0')
+                {
+                    throw JSON::DecodeException(*line);
+                }
+
+                s += (*s == '\\' && _peek(s + 1, end) != '\0') ? 2 : 1;
+            }
+            break;
+        case '\n':
+            *line += 1;
+            break;
+        case '\0':
+            throw JSON::DecodeException(*line);
+        default:
+            break;
+        }
+    }
+}
+
+/*
+ * _KeyPool
+ *
+ * Holds a single copy of every distinct key interned into it, together
+ * with the key's hash. Documents that intern their keys refer to these
+ * copies instead of storing keys of their own, and keep the pool alive.
+ * A pool may be shared between documents parsed on different threads.
+ */
+class JSON::_KeyPool
+{
+public:
+    struct _Entry
+    {
+        size_t _hash;
+        size_t _length;
+    };
+
+    std::atomic<size_t> _refs;
+    mutable std::mutex _mutex;
+    std::vector<_Entry *> _table;
+    size_t _size;
+    size_t _bytes;
+
+    _KeyPool();
+    ~_KeyPool();
+    const _Entry *_intern(const char *, size_t, size_t, size_t *, size_t *);
+    void _retain();
+    void _release();
+};
+
+JSON::_KeyPool::_KeyPool() : _refs(1), _table(64, NULL)
+{
+    _size = 0;
+    _bytes = sizeof(JSON::_KeyPool) + _table.size() * sizeof(_Entry *);
+}
+
+JSON::_KeyPool::~_KeyPool()
+{
+    for (auto &entry : _table)
+    {
+        free(entry);
+    }
+}
+
+// Returns the pooled copy of a key, adding it if it is new. What is added
+// is counted in allocations and bytes.
+const JSON::_KeyPool::_Entry *JSON::_KeyPool::_intern(const char *s, size_t length, size_t hash, size_t *allocations, size_t *bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    size_t mask = _table.size() - 1;
+    size_t slot = hash & mask;
+    for (; _table[slot] != NULL; slot = (slot + 1) & mask)
+    {
+        const _Entry *entry = _table[slot];
+        if (entry->_hash == hash && entry->_length == length && memcmp(entry + 1, s, length) == 0)
+        {
+            return entry;
+        }
+    }
+
+    _Entry *entry = (_Entry *)malloc(sizeof(_Entry) + length + 1);
+    if (entry == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    entry->_hash = hash;
+    entry->_length = length;
+    memcpy(entry + 1, s, length);
+    ((char *)(entry + 1))[length] = '\0';
+
+    _table[slot] = entry;
+    _size++;
+    _bytes += sizeof(_Entry) + length + 1;
+    *allocations += 1;
+    *bytes += sizeof(_Entry) + length + 1;
+
+    // The table is kept at most half full
+    if (_size * 2 > _table.size())
+    {
+        std::vector<_Entry *> table(_table.size() * 2, NULL);
+        mask = table.size() - 1;
+
+        for (auto &e : _table)
+        {
+            if (e != NULL)
+            {
+                for (slot = e->_hash & mask; table[slot] != NULL; slot = (slot + 1) & mask)
+                {
+                }
+
+                table[slot] = e;
+            }
+        }
+
+        _bytes += _table.size() * sizeof(_Entry *);
+        *allocations += 1;
+        *bytes += table.size() * sizeof(_Entry *);
+        _table.swap(table);
+    }
+
+    return entry;
+}
+
+void JSON::_KeyPool::_retain()
+{
+    _refs++;
+}
+
+void JSON::_KeyPool::_release()
+{
+    if (--_refs == 0)
+    {
+        delete this;
+    }
+}
+
+// Takes a reference to the pool a document interns its keys into: the one
+// it was given, or one of its own when it asks for PARSE_INTERN_KEYS
+JSON::_KeyPool *_open_pool(JSON::_KeyPool *pool, JSON::ParseMode mode)
+{
+    if (pool != NULL)
+    {
+        pool->_retain();
+        return pool;
+    }
+
+    return (mode & JSON::PARSE_INTERN_KEYS) ? new JSON::_KeyPool() : NULL;
+}
+
+/*
+ * KeyPool
+ */
+JSON::KeyPool::KeyPool()
+{
+    _pool = new JSON::_KeyPool();
+}
+
+// Copies refer to the same pool
+JSON::KeyPool::KeyPool(const JSON::KeyPool &other)
+{
+    _pool = other._pool;
+    _pool->_retain();
+}
+
+JSON::KeyPool::~KeyPool()
+{
+    _pool->_release();
+}
+
+JSON::KeyPool &JSON::KeyPool::operator=(const JSON::KeyPool &other)
+{
+    other._pool->_retain();
+    _pool->_release();
+    _pool = other._pool;
+    return *this;
+}
+
+// A key whose data is the pooled copy, which documents interned into this
+// pool compare by address before comparing bytes
+JSON::Key JSON::KeyPool::key(const char *s)
+{
+    if (s == NULL)
+    {
+        throw InvalidKeyException(s);
+    }
+
+    size_t length = strlen(s);
+    size_t allocations = 0;
+    size_t bytes = 0;
+    const JSON::_KeyPool::_Entry *entry = _pool->_intern(s, length, _string_hash(s, length), &allocations, &bytes);
+    return JSON::Key((const char *)(entry + 1), length);
+}
+
+JSON::Key JSON::KeyPool::key(std::string &s)
+{
+    return key(s.c_str());
+}
+
+size_t JSON::KeyPool::size() const
+{
+    std::lock_guard<std::mutex> lock(_pool->_mutex);
+    return _pool->_size;
+}
+
+size_t JSON::KeyPool::bytes() const
+{
+    std::lock_guard<std::mutex> lock(_pool->_mutex);
+    return _pool->_bytes;
+}
+
+/*
+ * _Arena
+ */
+class JSON::_Arena
+{
+public:
+    size_t _blocks;
+    size_t _reserved;
+    std::atomic<size_t> _refs;
+    std::atomic<bool> _frozen;
+    bool _borrows;
+    JSON::_KeyPool *_pool;
+
+    _Arena(size_t);
+    ~_Arena();
+    void *_allocate(size_t, size_t);
+    void _adopt(std::string *);
+    void _adopt(JSON::_Arena *);
+    void _retain();
+    void _release();
+    void _freeze();
+
+private:
+    struct _Block
+    {
+        _Block *_prev;
+        size_t _capacity;
+    };
+
+    _Block *_head;
+    char *_cursor;
+    char *_limit;
+    size_t _next_capacity;
+    std::vector<std::string *> _adopted;
+    std::vector<JSON::_Arena *> _children;
+
+    void _grow(size_t);
+};
+
+JSON::_Arena::_Arena(size_t capacity)
+{
+    _blocks = 0;
+    _reserved = 0;
+    _refs = 1;
+    _frozen = false;
+    _borrows = false;
+    _pool = NULL;
+    _head = NULL;
+    _cursor = NULL;
+    _limit = NULL;
+    _next_capacity = capacity < 4096 ? 4096 : capacity;
+}
+
+JSON::_Arena::~_Arena()
+{
+    for (auto &s : _adopted)
+    {
+        delete s;
+    }
+
+    for (auto &a : _children)
+    {
+        a->_release();
+    }
+
+    if (_pool != NULL)
+    {
+        _pool->_release();
+    }
+
+    while (_head != NULL)
+    {
+        _Block *prev = _head->_prev;
+        free(_head);
+        _head = prev;
+    }
+}
+
+void JSON::_Arena::_grow(size_t minimum)
+{
+    size_t capacity = _next_capacity;
+    while (capacity < minimum)
+    {
+        capacity *= 2;
+    }
+
+    _Block *block = (_Block *)malloc(sizeof(_Block) + capacity);
+    if (block == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    block->_prev = _head;
+    block->_capacity = capacity;
+    _head = block;
+    _cursor = (char *)(block + 1);
+    _limit = _cursor + capacity;
+
+    _blocks++;
+    _reserved += capacity;
+    _next_capacity = capacity * 2;
+}
+
+void *JSON::_Arena::_allocate(size_t size, size_t align)
+{
+    uintptr_t p = ((uintptr_t)_cursor + align - 1) & ~(uintptr_t)(align - 1);
+
+    if (_cursor == NULL || p + size > (uintptr_t)_limit)
+    {
+        _grow(size + align);
+        p = ((uintptr_t)_cursor + align - 1) & ~(uintptr_t)(align - 1);
+    }
+
+    _cursor = (char *)(p + size);
+    return (void *)p;
+}
+
+void JSON::_Arena::_adopt(std::string *s)
+{
+    _adopted.push_back(s);
+}
+
+// Keeps another arena alive for as long as this one, taking over the
+// caller's reference to it
+void JSON::_Arena::_adopt(JSON::_Arena *arena)
+{
+    _children.push_back(arena);
+    _blocks += arena->_blocks;
+    _reserved += arena->_reserved;
+}
+
+void JSON::_Arena::_retain()
+{
+    _refs++;
+}
+
+void JSON::_Arena::_release()
+{
+    if (--_refs == 0)
+    {
+        delete this;
+    }
+}
+
+// Marks the arena as shared between documents. What it holds, and what the
+// arenas it keeps alive hold, is never modified again. Copies of one
+// document may be made on several threads at once, so the arenas kept
+// alive are frozen first, and an arena seen as frozen has frozen them.
+void JSON::_Arena::_freeze()
+{
+    if (_frozen)
+    {
+        return;
+    }
+
+    for (auto &a : _children)
+    {
+        a->_freeze();
+    }
+
+    _frozen = true;
+}
+
+/*
+ * _Mapping
+ *
+ * Maps a file read-only where mmap is available and reads it into memory
+ * elsewhere.
+ */
+class JSON::_Mapping
+{
+public:
+    const char *_data;
+    size_t _length;
+
+    _Mapping(const char *, bool sequential = true);
+    ~_Mapping();
+};
+
+JSON::_Mapping::_Mapping(const char *path, bool sequential)
+{
+    _data = "";
+    _length = 0;
+
+    if (path == NULL)
+    {
+        throw JSON::FileException(path);
+    }
+
+#ifdef _JSON_MMAP
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        throw JSON::FileException(path);
+    }
+
+    if (st.st_size > 0)
+    {
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            close(fd);
+            throw JSON::FileException(path);
+        }
+
+        // The parser reads the file front to back exactly once. Snapshots
+        // are read wherever they are looked up, so they keep the default.
+        if (sequential)
+        {
+            madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        }
+
+        _data = (const char *)p;
+        _length = (size_t)st.st_size;
+    }
+
+    close(fd);
+#else
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        throw JSON::FileException(path);
+    }
+
+    std::string contents;
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) != 0)
+    {
+        contents.append(buffer, n);
+    }
+
+    bool failed = ferror(f) != 0;
+    fclose(f);
+    if (failed)
+    {
+        throw JSON::FileException(path);
+    }
+
+    if (!contents.empty())
+    {
+        char *p = new char[contents.length()];
+        memcpy(p, contents.data(), contents.length());
+        _data = p;
+        _length = contents.length();
+    }
+#endif
+}
+
+JSON::_Mapping::~_Mapping()
+{
+    if (_length == 0)
+    {
+        return;
+    }
+
+#ifdef _JSON_MMAP
+    munmap((void *)_data, _length);
+#else
+    delete[] _data;
+#endif
+}
+
+/*
+ * _Node
+ */
+void _free_string(JSON::_String &s)
+{
+    if (s._value != NULL)
+    {
+        delete s._value;
+    }
+}
+
+void _free_node(JSON::_Node &node)
+{
+    switch (node._type)
+    {
+    case JSON::OBJECT:
+        if (node._object != NULL)
+        {
+            delete node._object;
+        }
+        break;
+    case JSON::STRING:
+        _free_string(node._string);
+        break;
+    default:
+        break;
+    }
+}
+
+void _copy_string(JSON::_String *dst, const JSON::_String &src, JSON::_Arena *arena)
+{
+    size_t length = _string_length(src);
+    char *p = (char *)arena->_allocate(length + 1, 1);
+    memcpy(p, _string_data(src), length);
+    p[length] = '\0';
+
+    dst->_data = p;
+    dst->_length = length;
+    dst->_value = NULL;
+}
+
+// A string shared with a frozen arena refers to the text of the string it
+// was copied from, so that materializing it creates a string of its own
+void _detach_string(JSON::_String *s)
+{
+    if (s->_value != NULL)
+    {
+        s->_data = s->_value->c_str();
+        s->_length = s->_value->length();
+        s->_value = NULL;
+    }
+}
+
+/*
+ * _Context
+ */
+class JSON::_Context
+{
+public:
+    JSON::_Arena *_arena;
+    JSON::ParseMode _mode;
+    const char *_end;
+    int _line;
+    size_t _allocations;
+    size_t _bytes;
+    std::vector<JSON::_Node> _nodes;
+    std::vector<JSON::_String> _keys;
+    std::string _buffer;
+    JSON::_KeyPool *_pool;
+    std::vector<size_t> _hashes;
+    const JSON::_KeyPool::_Entry *_cache[64];
+
+    _Context(JSON::_Arena *, JSON::ParseMode, const char *);
+    JSON::Object *_new_object();
+    JSON::_Slot *_new_slots(size_t);
+    template <typename T>
+    void _push(std::vector<T> &, const T &);
+    template <typename T>
+    T *_pop(std::vector<T> &, size_t);
+    void _store(JSON::_String *, const char *, size_t);
+    const char *_consume_string(const char *, JSON::_String *);
+    const char *_intern(const char *, size_t, size_t *);
+    void _push_key(const char *, size_t);
+    const char *_consume_key(const char *);
+    const char *_elements(const char *);
+    void _unwind(size_t, size_t);
+    void _report(JSON::ParseStats *);
+};
+
+JSON::_Context::_Context(JSON::_Arena *arena, JSON::ParseMode mode, const char *end)
+{
+    _arena = arena;
+    _mode = mode;
+    _end = end;
+    _line = 1;
+    _allocations = 0;
+    _bytes = 0;
+    _pool = NULL;
+    memset(_cache, 0, sizeof(_cache));
+}
+
+// Objects outside an arena each keep the pool their keys are interned into
+// alive, since any of them may be moved out of the document
+JSON::Object *JSON::_Context::_new_object()
+{
+    JSON::Object *object;
+
+    if (_arena != NULL)
+    {
+        object = new (_arena->_allocate(sizeof(JSON::Object), alignof(JSON::Object))) JSON::Object();
+        object->_pool = _pool;
+        return object;
+    }
+
+    _allocations++;
+    _bytes += sizeof(JSON::Object);
+    object = new JSON::Object();
+
+    if (_pool != NULL)
+    {
+        _pool->_retain();
+        object->_pool = _pool;
+    }
+
+    return object;
+}
+
+JSON::_Slot *JSON::_Context::_new_slots(size_t capacity)
+{
+    if (_arena != NULL)
+    {
+        void *p = _arena->_allocate(capacity * sizeof(JSON::_Slot), alignof(JSON::_Slot));
+        return (JSON::_Slot *)memset(p, 0, capacity * sizeof(JSON::_Slot));
+    }
+
+    _allocations++;
+    _bytes += capacity * sizeof(JSON::_Slot);
+    return new JSON::_Slot[capacity]();
+}
+
+template <typename T>
+void JSON::_Context::_push(std::vector<T> &stack, const T &value)
+{
+    if (stack.size() == stack.capacity())
+    {
+        _allocations++;
+    }
+
+    stack.push_back(value);
+}
+
+// Moves everything above base off the scratch stack into one exactly sized
+// block, so that the elements of an object or array end up contiguous.
+template <typename T>
+T *JSON::_Context::_pop(std::vector<T> &stack, size_t base)
+{
+    size_t count = stack.size() - base;
+    T *items = NULL;
+
+    if (count != 0)
+    {
+        if (_arena != NULL)
+        {
+            items = (T *)_arena->_allocate(count * sizeof(T), alignof(T));
+        }
+        else
+        {
+            items = new T[count];
+            _allocations++;
+            _bytes += count * sizeof(T);
+        }
+
+        memcpy(items, &stack[base], count * sizeof(T));
+    }
+
+    stack.resize(base);
+    return items;
+}
+
+void JSON::_Context::_store(JSON::_String *dst, const char *s, size_t length)
+{
+    if (_arena != NULL)
+    {
+        char *p = (char *)_arena->_allocate(length + 1, 1);
+        memcpy(p, s, length);
+        p[length] = '\0';
+
+        dst->_data = p;
+        dst->_length = length;
+        dst->_value = NULL;
+        return;
+    }
+
+    std::string *value = new std::string(s, length);
+    _allocations++;
+    _bytes += sizeof(std::string);
+
+    // Count the character buffer if it did not fit in the small string buffer
+    if (value->data() < (const char *)value || value->data() >= (const char *)(value + 1))
+    {
+        _allocations++;
+        _bytes += value->capacity() + 1;
+    }
+
+    dst->_data = NULL;
+    dst->_length = 0;
+    dst->_value = value;
+}
+
+const char *JSON::_Context::_consume_string(const char *s, JSON::_String *dst)
+{
+    if (_mode & JSON::PARSE_ZERO_COPY)
+    {
+        // Strings without escapes are left where they are in the input
+        const char *run = _kernels().scan_string(s + 1, _end);
+        if (_peek(run, _end) == '"')
+        {
+            dst->_data = s + 1;
+            dst->_length = run - s - 1;
+            dst->_value = NULL;
+            return run + 1;
+        }
+    }
+
+    s = ::_consume_string(s, _end, &_buffer, _line);
+    _store(dst, _buffer.c_str(), _buffer.length());
+    return s;
+}
+
+// Returns the pooled copy of a key and its hash. Recently seen keys are
+// found in a small cache of this context's, so that the pool, which may be
+// shared with other threads, is only consulted for keys new to the parse.
+const char *JSON::_Context::_intern(const char *s, size_t length, size_t *hash)
+{
+    *hash = _string_hash(s, length);
+
+    const JSON::_KeyPool::_Entry *&entry = _cache[*hash % (sizeof(_cache) / sizeof(_cache[0]))];
+    if (entry == NULL || entry->_hash != *hash || entry->_length != length || memcmp(entry + 1, s, length) != 0)
+    {
+        entry = _pool->_intern(s, length, *hash, &_allocations, &_bytes);
+    }
+
+    return (const char *)(entry + 1);
+}
+
+// Pushes a key onto the scratch stack. Interned keys are pushed along with
+// their hashes, which the object's index is then built from.
+void JSON::_Context::_push_key(const char *s, size_t length)
+{
+    JSON::_String key;
+
+    if (_pool != NULL)
+    {
+        size_t hash;
+        key._data = _intern(s, length, &hash);
+        key._length = length;
+        key._value = NULL;
+        _push(_hashes, hash);
+    }
+    else
+    {
+        _store(&key, s, length);
+    }
+
+    _push(_keys, key);
+}
+
+const char *JSON::_Context::_consume_key(const char *s)
+{
+    if (_pool == NULL)
+    {
+        JSON::_String key;
+        s = _consume_string(s, &key);
+        _push(_keys, key);
+        return s;
+    }
+
+    // Keys without escapes are interned straight from the input
+    const char *run = _kernels().scan_string(s + 1, _end);
+    if (_peek(run, _end) == '"')
+    {
+        _push_key(s + 1, run - s - 1);
+        return run + 1;
+    }
+
+    s = ::_consume_string(s, _end, &_buffer, _line);
+    _push_key(_buffer.data(), _buffer.length());
+    return s;
+}
+
+// Parses comma-separated array elements up to the end of the input
+const char *JSON::_Context::_elements(const char *s)
+{
+    while (true)
+    {
+        s = _consume_whitespace(s, _end, &_line);
+
+        JSON::_Node null_node;
+        null_node._type = JSON::JSON_NULL;
+        _push(_nodes, null_node);
+        s = JSON::Object::_value(s, &_nodes.back(), this);
+
+        s = _consume_whitespace(s, _end, &_line);
+        if (s == _end)
+        {
+            return s;
+        }
+
+        if (*s != ',')
+        {
+            throw JSON::DecodeException(_line);
+        }
+
+        s++;
+    }
+}
+
+// Drops the members of an object that failed to parse off the scratch stacks
+void JSON::_Context::_unwind(size_t base, size_t key_base)
+{
+    if (_arena == NULL)
+    {
+        for (size_t i = base; i < _nodes.size(); i++)
+        {
+            _free_node(_nodes[i]);
+        }
+
+        for (size_t i = key_base; i < _keys.size(); i++)
+        {
+            _free_string(_keys[i]);
+        }
+    }
+
+    _nodes.resize(base);
+    _keys.resize(key_base);
+
+    if (_pool != NULL)
+    {
+        _hashes.resize(key_base);
+    }
+}
+
+void JSON::_Context::_report(JSON::ParseStats *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    stats->allocations = _allocations;
+    stats->bytes = _bytes;
+
+    if (_buffer.capacity() > sizeof(std::string))
+    {
+        stats->allocations++;
+    }
+
+    if (_arena != NULL)
+    {
+        stats->allocations += 1 + _arena->_blocks;
+        stats->bytes += sizeof(JSON::_Arena) + _arena->_reserved;
+    }
+}
+
+void _parse_elements(JSON::_Context *ctx, const char *s, std::exception_ptr *error)
+{
+    try
+    {
+        ctx->_elements(s);
+    }
+    catch (...)
+    {
+        *error = std::current_exception();
+    }
+}
+
+/*
+ * _Writer
+ */
+class JSON::_Writer
+{
+public:
+    std::string *_out;
+    unsigned int _indent;
+
+    _Writer(std::string *, unsigned int);
+    _Writer(JSON::Sink, void *, unsigned int);
+    ~_Writer();
+    void _newline(unsigned int);
+    void _reserve(size_t);
+    void _flush();
+
+private:
+    JSON::Sink _sink;
+    void *_context;
+    std::string _buffer;
+};
+
+JSON::_Writer::_Writer(std::string *out, unsigned int indent)
+{
+    _out = out;
+    _indent = indent;
+    _sink = NULL;
+    _context = NULL;
+}
+
+JSON::_Writer::_Writer(JSON::Sink sink, void *context, unsigned int indent)
+{
+    _out = &_buffer;
+    _indent = indent;
+    _sink = sink;
+    _context = context;
+    _buffer.reserve(8192);
+}
+
+JSON::_Writer::~_Writer()
+{
+    if (_sink != NULL && !_buffer.empty())
+    {
+        _sink(_buffer.data(), _buffer.length(), _context);
+    }
+}
+
+void JSON::_Writer::_newline(unsigned int depth)
+{
+    if (_indent != 0)
+    {
+        _out->append("\r\n", 2);
+        _out->append((size_t)_indent * depth, ' ');
+    }
+}
+
+void JSON::_Writer::_reserve(size_t size)
+{
+    if (_sink == NULL && _out->capacity() < _out->length() + size)
+    {
+        _out->reserve(_out->length() + size);
+    }
+}
+
+// Hands completed output to the sink once the buffer fills up
+void JSON::_Writer::_flush()
+{
+    if (_sink != NULL && _buffer.length() >= 4096)
+    {
+        _sink(_buffer.data(), _buffer.length(), _context);
+        _buffer.clear();
+    }
+}
+
+void _ostream_sink(const char *data, size_t length, void *context)
+{
+    ((std::ostream *)context)->write(data, length);
+}
+
+/*
+ * Object
+ */
+JSON::Object::Object()
+{
+    _is_array = false;
+    _owns_arena = false;
+    _size = 0;
+    _allocated = 0;
+    _capacity = 0;
+    _map = NULL;
+    _items = NULL;
+    _keys = NULL;
+    _arena = NULL;
+    _pool = NULL;
+    _source = NULL;
+    _source_end = NULL;
+    _line = 0;
+    _mode = JSON::PARSE_DEFAULT;
+    _mapping = NULL;
+}
+
+JSON::Object::Object(const char *s)
+{
+    _parse(s, NULL, JSON::PARSE_DEFAULT, NULL, NULL);
+}
+
+JSON::Object::Object(std::string &s)
+{
+    _parse(s.c_str(), NULL, JSON::PARSE_DEFAULT, NULL, NULL);
+}
+
+JSON::Object::Object(const char *s, const char **r)
+{
+    *r = _parse(s, NULL, JSON::PARSE_DEFAULT, NULL, NULL);
+}
+
+JSON::Object::Object(const char *s, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    _parse(s, NULL, mode, stats, NULL);
+}
+
+JSON::Object::Object(std::string &s, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    _parse(s.c_str(), NULL, mode, stats, NULL);
+}
+
+JSON::Object::Object(const char *data, size_t length)
+{
+    _parse(data, data + length, JSON::PARSE_DEFAULT, NULL, NULL);
+}
+
+JSON::Object::Object(const char *data, size_t length, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    _parse(data, data + length, mode, stats, NULL);
+}
+
+// Keys are interned into the given pool, which other documents may share
+JSON::Object::Object(const char *s, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    _parse(s, NULL, mode, stats, pool._pool);
+}
+
+JSON::Object::Object(std::string &s, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    _parse(s.c_str(), NULL, mode, stats, pool._pool);
+}
+
+JSON::Object::Object(const char *data, size_t length, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    _parse(data, data + length, mode, stats, pool._pool);
+}
+
+JSON::Object JSON::Object::from_file(const char *path, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    return _from_file(path, mode, stats, NULL);
+}
+
+JSON::Object JSON::Object::from_file(const char *path, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    return _from_file(path, mode, stats, pool._pool);
+}
+
+JSON::Object JSON::Object::from_file(std::string &path, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    return _from_file(path.c_str(), mode, stats, pool._pool);
+}
+
+JSON::Object JSON::Object::_from_file(const char *path, JSON::ParseMode mode, JSON::ParseStats *stats, JSON::_KeyPool *pool)
+{
+    JSON::Object object;
+    JSON::_Mapping *mapping = new JSON::_Mapping(path);
+
+    try
+    {
+        object._parse(mapping->_data, mapping->_data + mapping->_length, mode, stats, pool);
+    }
+    catch (...)
+    {
+        delete mapping;
+        throw;
+    }
+
+    // Lazy and zero-copy documents keep pointing into the file
+    if (mode & (JSON::PARSE_LAZY | JSON::PARSE_ZERO_COPY))
+    {
+        object._mapping = mapping;
+    }
+    else
+    {
+        delete mapping;
+    }
+
+    return object;
+}
+
+JSON::Object JSON::Object::from_file(std::string &path, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    return from_file(path.c_str(), mode, stats);
+}
+
+// Empty documents to be filled in with set() and append(). Only
+// PARSE_ARENA has any effect on them.
+JSON::Object JSON::Object::object(JSON::ParseMode mode)
+{
+    JSON::Object result;
+
+    if (mode & JSON::PARSE_ARENA)
+    {
+        result._arena = new JSON::_Arena(0);
+        result._owns_arena = true;
+    }
+
+    return result;
+}
+
+JSON::Object JSON::Object::array(JSON::ParseMode mode)
+{
+    JSON::Object result = object(mode);
+    result._is_array = true;
+    return result;
+}
+
+// Input with an explicit end must hold exactly one document, while
+// NUL-terminated input may continue after it and the rest is returned.
+const char *JSON::Object::_parse(const char *s, const char *end, JSON::ParseMode mode, JSON::ParseStats *stats, JSON::_KeyPool *pool)
+{
+    if (s == NULL)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    _is_array = false;
+    _owns_arena = false;
+    _size = 0;
+    _allocated = 0;
+    _capacity = 0;
+    _map = NULL;
+    _items = NULL;
+    _keys = NULL;
+    _arena = NULL;
+    _pool = NULL;
+    _source = NULL;
+    _source_end = NULL;
+    _line = 0;
+    _mode = JSON::PARSE_DEFAULT;
+    _mapping = NULL;
+
+    const char *limit = end;
+    if (limit == NULL && (mode & (JSON::PARSE_ARENA | JSON::PARSE_PARALLEL)))
+    {
+        limit = s + strlen(s);
+    }
+
+    JSON::_KeyPool *keys = _open_pool(pool, mode);
+    JSON::_Arena *arena = NULL;
+    if (mode & JSON::PARSE_ARENA)
+    {
+        // Nodes cost more than the text they are parsed from, so start the
+        // arena large enough that most documents fit in one or two blocks.
+        try
+        {
+            arena = new JSON::_Arena((limit - s) * 2);
+        }
+        catch (...)
+        {
+            if (keys != NULL)
+            {
+                keys->_release();
+            }
+            throw;
+        }
+
+        arena->_borrows = (mode & (JSON::PARSE_LAZY | JSON::PARSE_ZERO_COPY)) != 0;
+
+        // The arena keeps the pool alive for the whole document
+        arena->_pool = keys;
+    }
+
+    // Splitting only pays off once each thread has a good amount of work
+    unsigned int threads = 1;
+    if ((mode & JSON::PARSE_PARALLEL) && limit - s >= (1 << 20))
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    JSON::_Context ctx(arena, mode, end != NULL ? end : _no_end);
+    ctx._pool = keys;
+    if (keys != NULL && pool == NULL)
+    {
+        ctx._allocations += 2;
+        ctx._bytes += keys->_bytes;
+    }
+
+    try
+    {
+        if (threads > 1)
+        {
+            s = _initialize_parallel(s, limit, &ctx, threads);
+        }
+        else
+        {
+            s = _initialize(s, &ctx);
+        }
+
+        if (end != NULL)
+        {
+            s = _consume_whitespace(s, end, &ctx._line);
+            if (s != end)
+            {
+                throw JSON::DecodeException(ctx._line);
+            }
+        }
+    }
+    catch (...)
+    {
+        _release();
+        delete arena;
+
+        if (keys != NULL && arena == NULL)
+        {
+            keys->_release();
+        }
+
+        // Leave an empty object for the destructor of a factory's result
+        _size = 0;
+        _items = NULL;
+        _keys = NULL;
+        _map = NULL;
+        _arena = NULL;
+        throw;
+    }
+
+    _owns_arena = arena != NULL;
+    _pool = keys;
+
+    ctx._report(stats);
+    return s;
+}
+
+const char *JSON::Object::_initialize(const char *s, JSON::_Context *ctx)
+{
+    if (s == NULL)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    _arena = ctx->_arena;
+    size_t base = ctx->_nodes.size();
+    size_t key_base = ctx->_keys.size();
+
+    try
+    {
+        s = _consume_whitespace(s, ctx->_end, &ctx->_line);
+        if (_peek(s, ctx->_end) == '[')
+        {
+            _is_array = true;
+        }
+        else if (_peek(s, ctx->_end) == '{')
+        {
+            _is_array = false;
+        }
+        else
+        {
+            throw JSON::DecodeException(ctx->_line);
+        }
+
+        s = _consume_whitespace(s + 1, ctx->_end, &ctx->_line);
+        if (_peek(s, ctx->_end) != (_is_array ? ']' : '}'))
+        {
+            while (true)
+            {
+                s = _consume_whitespace(s, ctx->_end, &ctx->_line);
+
+                // Parse key
+                if (!_is_array)
+                {
+                    if (_peek(s, ctx->_end) != '"')
+                    {
+                        throw JSON::DecodeException(ctx->_line);
+                    }
+
+                    s = ctx->_consume_key(s);
+                    s = _consume_whitespace(s, ctx->_end, &ctx->_line);
+                    if (_peek(s, ctx->_end) != ':')
+                    {
+                        throw JSON::DecodeException(ctx->_line);
+                    }
+                    else
+                    {
+                        s = _consume_whitespace(s + 1, ctx->_end, &ctx->_line);
+                    }
+                }
+
+                // Anticipate next node. It is only valid until a child is
+                // parsed, since the child grows the same scratch stack.
+                JSON::_Node null_node;
+                null_node._type = JSON::JSON_NULL;
+                ctx->_push(ctx->_nodes, null_node);
+                s = _value(s, &ctx->_nodes.back(), ctx);
+
+                s = _consume_whitespace(s, ctx->_end, &ctx->_line);
+                if (_peek(s, ctx->_end) == (_is_array ? ']' : '}'))
+                {
+                    s++;
+                    break;
+                }
+                else if (_peek(s, ctx->_end) == ',')
+                {
+                    s++;
+                }
+                else
+                {
+                    throw JSON::DecodeException(ctx->_line);
+                }
+            }
+        }
+        else
+        {
+            s++;
+        }
+    }
+    catch (...)
+    {
+        ctx->_unwind(base, key_base);
+        throw;
+    }
+
+    _assemble(ctx, base, key_base);
+    return s;
+}
+
+// Parses a large top-level array on several threads. A structural scan
+// divides its elements into ranges of about equal size, each range is
+// parsed with a context and arena of its own, and the results are joined.
+// Malformed input is parsed again on one thread, so that errors are
+// reported exactly as they would be without splitting.
+const char *JSON::Object::_initialize_parallel(const char *s, const char *end, JSON::_Context *ctx, unsigned int threads)
+{
+    int line = ctx->_line;
+    const char *open = _consume_whitespace(s, end, &line);
+    if (_peek(open, end) != '[')
+    {
+        return _initialize(s, ctx);
+    }
+
+    std::vector<const char *> splits(1, open + 1);
+    std::vector<int> lines(1, line);
+    const char *close;
+
+    try
+    {
+        close = _split_array(open, end, &line, threads, &splits, &lines);
+    }
+    catch (JSON::DecodeException &)
+    {
+        return _initialize(s, ctx);
+    }
+
+    if (splits.size() == 1)
+    {
+        return _initialize(s, ctx);
+    }
+
+    size_t count = splits.size();
+    std::vector<JSON::_Context *> contexts(count, NULL);
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const char *range_end = i + 1 < count ? splits[i + 1] - 1 : close;
+        JSON::_Arena *arena = ctx->_arena;
+        if (arena != NULL && i != 0)
+        {
+            arena = new JSON::_Arena((range_end - splits[i]) * 2);
+            arena->_borrows = ctx->_arena->_borrows;
+        }
+
+        contexts[i] = new JSON::_Context(arena, ctx->_mode, range_end);
+        contexts[i]->_line = lines[i];
+        contexts[i]->_pool = ctx->_pool;
+    }
+
+    // The first range is parsed on this thread
+    for (size_t i = 1; i < count; i++)
+    {
+        try
+        {
+            workers.push_back(std::thread(_parse_elements, contexts[i], splits[i], &errors[i]));
+        }
+        catch (...)
+        {
+            _parse_elements(contexts[i], splits[i], &errors[i]);
+        }
+    }
+
+    _parse_elements(contexts[0], splits[0], &errors[0]);
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    bool error = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        error = error || errors[i];
+    }
+
+    size_t base = ctx->_nodes.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        JSON::_Context *range = contexts[i];
+
+        if (error && range->_arena == NULL)
+        {
+            for (size_t j = 0; j < range->_nodes.size(); j++)
+            {
+                _free_node(range->_nodes[j]);
+            }
+
+            for (size_t j = 0; j < range->_keys.size(); j++)
+            {
+                _free_string(range->_keys[j]);
+            }
+        }
+        else if (!error)
+        {
+            ctx->_nodes.insert(ctx->_nodes.end(), range->_nodes.begin(), range->_nodes.end());
+            ctx->_allocations += range->_allocations;
+            ctx->_bytes += range->_bytes;
+        }
+
+        // Elements keep pointing at the arena they were parsed into
+        if (range->_arena != ctx->_arena)
+        {
+            if (error)
+            {
+                delete range->_arena;
+            }
+            else
+            {
+                ctx->_arena->_adopt(range->_arena);
+                ctx->_allocations++;
+                ctx->_bytes += sizeof(JSON::_Arena);
+            }
+        }
+
+        delete range;
+    }
+
+    if (error)
+    {
+        return _initialize(s, ctx);
+    }
+
+    _arena = ctx->_arena;
+    _is_array = true;
+    _assemble(ctx, base, ctx->_keys.size());
+
+    ctx->_line = line;
+    return close + 1;
+}
+
+// Parses the value at s into node
+const char *JSON::Object::_value(const char *s, JSON::_Node *node, JSON::_Context *ctx)
+{
+    switch (_peek(s, ctx->_end))
+    {
+    case 't':
+        s = _CONSUME_TRUE(s, ctx->_end, ctx->_line);
+        node->_type = JSON::BOOLEAN;
+        node->_boolean = true;
+        break;
+    case 'f':
+        s = _CONSUME_FALSE(s, ctx->_end, ctx->_line);
+        node->_type = JSON::BOOLEAN;
+        node->_boolean = false;
+        break;
+    case 'n':
+        s = _CONSUME_NULL(s, ctx->_end, ctx->_line);
+        node->_type = JSON::JSON_NULL;
+        break;
+    case '"':
+        s = ctx->_consume_string(s, &node->_string);
+        node->_type = JSON::STRING;
+        break;
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+    case '-':
+        s = _consume_number(s, ctx->_end, &node->_number, ctx->_line);
+        node->_type = JSON::NUMBER;
+        break;
+    case '{':
+    case '[':
+    {
+        // The node owns the child before it is parsed so that a
+        // failure inside the child is cleaned up with the node.
+        JSON::Object *child = ctx->_new_object();
+        node->_object = child;
+        node->_type = JSON::OBJECT;
+
+        if (ctx->_mode & JSON::PARSE_LAZY)
+        {
+            // Only remember where the child starts for now
+            child->_arena = ctx->_arena;
+            child->_mode = ctx->_mode;
+            child->_source = s;
+            child->_line = ctx->_line;
+            s = _skip_container(s, ctx->_end, &ctx->_line);
+            child->_source_end = s;
+        }
+        else
+        {
+            s = child->_initialize(s, ctx);
+        }
+        break;
+    }
+    default:
+        throw JSON::DecodeException(ctx->_line);
+    }
+
+    return s;
+}
+
+// Takes this object's members off the top of the scratch stacks
+void JSON::Object::_assemble(JSON::_Context *ctx, size_t base, size_t key_base)
+{
+    // Arrays are addressed by position and need neither keys nor an index
+    _size = ctx->_nodes.size() - base;
+    _allocated = _size;
+    _items = ctx->_pop(ctx->_nodes, base);
+
+    if (!_is_array)
+    {
+        _keys = ctx->_pop(ctx->_keys, key_base);
+        _capacity = _table_capacity(_size);
+        _map = ctx->_new_slots(_capacity);
+
+        if (ctx->_pool == NULL)
+        {
+            _build_index();
+            return;
+        }
+
+        for (size_t i = 0; i < _size; i++)
+        {
+            _index(&_items[i], ctx->_hashes[key_base + i], _keys[i]._length);
+        }
+
+        ctx->_hashes.resize(key_base);
+    }
+}
+
+void JSON::Object::_build_index()
+{
+    for (size_t i = 0; i < _size; i++)
+    {
+        size_t length = _string_length(_keys[i]);
+        _index(&_items[i], _string_hash(_string_data(_keys[i]), length), length);
+    }
+}
+
+void JSON::Object::_index(JSON::_Node *node, size_t hash, size_t length)
+{
+    size_t mask = _capacity - 1;
+
+    size_t slot = hash & mask;
+    while (_map[slot]._node != NULL)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    _map[slot]._hash = (uint32_t)((uint64_t)hash >> 32);
+    _map[slot]._length = (uint32_t)length;
+    _map[slot]._node = node;
+}
+
+void JSON::Object::_load()
+{
+    if (_source == NULL)
+    {
+        return;
+    }
+
+    JSON::_Context ctx(_arena, _mode, _source_end);
+    ctx._line = _line;
+    ctx._pool = _pool;
+    _initialize(_source, &ctx);
+    _source = NULL;
+}
+
+// Copying an arena-backed object shares its arena, which is frozen from then
+// on, so the copy takes constant time. Other objects, and those borrowing
+// from their input text, are cloned into an arena in a single pass, with
+// each index copied and its pointers rebased instead of being rebuilt.
+JSON::Object::Object(const JSON::Object &other)
+{
+    _is_array = false;
+    _owns_arena = true;
+    _size = 0;
+    _allocated = 0;
+    _capacity = 0;
+    _map = NULL;
+    _items = NULL;
+    _keys = NULL;
+    _pool = NULL;
+    _source = NULL;
+    _source_end = NULL;
+    _line = 0;
+    _mode = JSON::PARSE_DEFAULT;
+    _mapping = NULL;
+
+    if (other._arena != NULL && !other._arena->_borrows)
+    {
+        _link(other);
+        return;
+    }
+
+    // An arena-backed source tells how much room its tree needs
+    _arena = new JSON::_Arena(other._owns_arena ? other._arena->_reserved : 0);
+
+    try
+    {
+        _clone(other, _arena);
+    }
+    catch (...)
+    {
+        delete _arena;
+        throw;
+    }
+}
+
+// An object inside an arena-backed document cannot give its contents away,
+// so the arena is shared instead. An arena that borrows its input text may
+// still have lazy objects to fill in and is never shared, so the object is
+// cloned as a copy would be.
+JSON::Object::Object(JSON::Object &&other) noexcept
+{
+    if (other._arena != NULL && !other._owns_arena)
+    {
+        _mode = JSON::PARSE_DEFAULT;
+        _line = 0;
+        _mapping = NULL;
+
+        if (other._arena->_borrows)
+        {
+            _owns_arena = true;
+            _pool = NULL;
+            _arena = new JSON::_Arena(0);
+            _clone(other, _arena);
+            return;
+        }
+
+        _link(other);
+        return;
+    }
+
+    _steal(other);
+}
+
+// An object inside an arena-backed document is never destroyed on its own,
+// so whatever is assigned to it is copied into that document's arena.
+JSON::Object &JSON::Object::operator=(const JSON::Object &other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    if (_arena != NULL && !_owns_arena)
+    {
+        _assign(other);
+        return *this;
+    }
+
+    JSON::Object copy(other);
+    _release();
+    _steal(copy);
+    return *this;
+}
+
+JSON::Object &JSON::Object::operator=(JSON::Object &&other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    if (_arena != NULL && !_owns_arena)
+    {
+        _assign(other);
+        return *this;
+    }
+
+    // other may be part of this object's tree, so it is taken out first
+    JSON::Object taken(std::move(other));
+    _release();
+    _steal(taken);
+    return *this;
+}
+
+// Replaces an object inside an arena-backed document with a copy of other
+// in the same arena. other may contain this object, so the copy is made in
+// full before anything here is overwritten.
+void JSON::Object::_assign(const JSON::Object &other)
+{
+    JSON::Object copy;
+    copy._clone(other, _arena);
+    _steal(copy);
+}
+
+// Takes over everything other owns and leaves it an empty object
+void JSON::Object::_steal(JSON::Object &other)
+{
+    _is_array = other._is_array;
+    _owns_arena = other._owns_arena;
+    _mode = other._mode;
+    _size = other._size;
+    _allocated = other._allocated;
+    _capacity = other._capacity;
+    _map = other._map;
+    _items = other._items;
+    _keys = other._keys;
+    _arena = other._arena;
+    _pool = other._pool;
+    _source = other._source;
+    _source_end = other._source_end;
+    _line = other._line;
+    _mapping = other._mapping;
+
+    other._owns_arena = false;
+    other._size = 0;
+    other._allocated = 0;
+    other._capacity = 0;
+    other._map = NULL;
+    other._items = NULL;
+    other._keys = NULL;
+    other._arena = NULL;
+    other._pool = NULL;
+    other._source = NULL;
+    other._source_end = NULL;
+    other._mapping = NULL;
+}
+
+void JSON::Object::_clone(const JSON::Object &other, JSON::_Arena *arena)
+{
+    const_cast<JSON::Object &>(other)._load();
+
+    _is_array = other._is_array;
+    _arena = arena;
+    _size = other._size;
+    _allocated = other._size;
+    _capacity = other._capacity;
+    _map = NULL;
+    _items = NULL;
+    _keys = NULL;
+    _source = NULL;
+    _source_end = NULL;
+
+    if (_size == 0)
+    {
+        return;
+    }
+
+    _items = (JSON::_Node *)arena->_allocate(_size * sizeof(JSON::_Node), alignof(JSON::_Node));
+    for (size_t i = 0; i < _size; i++)
+    {
+        const JSON::_Node &src = other._items[i];
+        JSON::_Node *dst = &_items[i];
+        dst->_type = src._type;
+
+        switch (src._type)
+        {
+        case JSON::OBJECT:
+            dst->_object = new (arena->_allocate(sizeof(JSON::Object), alignof(JSON::Object))) JSON::Object();
+            dst->_object->_clone(*src._object, arena);
+            break;
+        case JSON::STRING:
+            _copy_string(&dst->_string, src._string, arena);
+            break;
+        case JSON::NUMBER:
+            dst->_number = src._number;
+            break;
+        case JSON::BOOLEAN:
+            dst->_boolean = src._boolean;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!_is_array)
+    {
+        _keys = (JSON::_String *)arena->_allocate(_size * sizeof(JSON::_String), alignof(JSON::_String));
+        for (size_t i = 0; i < _size; i++)
+        {
+            _copy_string(&_keys[i], other._keys[i], arena);
+        }
+
+        _map = (JSON::_Slot *)arena->_allocate(_capacity * sizeof(JSON::_Slot), alignof(JSON::_Slot));
+        for (size_t i = 0; i < _capacity; i++)
+        {
+            _map[i] = other._map[i];
+            if (_map[i]._node != NULL)
+            {
+                _map[i]._node = _items + (other._map[i]._node - other._items);
+            }
+        }
+    }
+}
+
+// Copies the top level of other into arena. Nested objects and the text of
+// strings are not copied but shared with other, and if other has not been parsed yet,
+// it is parsed into arena when first used.
+void JSON::Object::_share(const JSON::Object &other, JSON::_Arena *arena)
+{
+    JSON::_Node *items = NULL;
+    JSON::_String *keys = NULL;
+    JSON::_Slot *map = NULL;
+
+    if (other._size != 0)
+    {
+        items = (JSON::_Node *)arena->_allocate(other._size * sizeof(JSON::_Node), alignof(JSON::_Node));
+        memcpy(items, other._items, other._size * sizeof(JSON::_Node));
+        for (size_t i = 0; i < other._size; i++)
+        {
+            if (items[i]._type == JSON::STRING)
+            {
+                _detach_string(&items[i]._string);
+            }
+        }
+    }
+
+    if (other._size != 0 && !other._is_array)
+    {
+        keys = (JSON::_String *)arena->_allocate(other._size * sizeof(JSON::_String), alignof(JSON::_String));
+        memcpy(keys, other._keys, other._size * sizeof(JSON::_String));
+        for (size_t i = 0; i < other._size; i++)
+        {
+            _detach_string(&keys[i]);
+        }
+
+        map = (JSON::_Slot *)arena->_allocate(other._capacity * sizeof(JSON::_Slot), alignof(JSON::_Slot));
+        for (size_t i = 0; i < other._capacity; i++)
+        {
+            map[i] = other._map[i];
+            if (map[i]._node != NULL)
+            {
+                map[i]._node = items + (other._map[i]._node - other._items);
+            }
+        }
+    }
+
+    _is_array = other._is_array;
+    _size = other._size;
+    _allocated = other._size;
+    _capacity = other._capacity;
+    _map = map;
+    _items = items;
+    _keys = keys;
+    _arena = arena;
+    _pool = other._pool;
+    _source = other._source;
+    _source_end = other._source_end;
+    _line = other._line;
+    _mode = other._mode;
+}
+
+// Refers to the arena of other, which is frozen from then on, and to the
+// members stored in it
+void JSON::Object::_link(const JSON::Object &other)
+{
+    other._arena->_freeze();
+    other._arena->_retain();
+
+    _is_array = other._is_array;
+    _owns_arena = true;
+    _size = other._size;
+    _allocated = other._allocated;
+    _capacity = other._capacity;
+    _map = other._map;
+    _items = other._items;
+    _keys = other._keys;
+    _arena = other._arena;
+    _pool = other._pool;
+    _source = NULL;
+    _source_end = NULL;
+}
+
+// A document whose arena has been frozen by a copy moves its top level into
+// a new arena of its own before anything in it can be changed. The new
+// arena keeps the frozen one alive.
+void JSON::Object::_own()
+{
+    if (_arena == NULL || !_arena->_frozen || !_owns_arena)
+    {
+        return;
+    }
+
+    JSON::_Arena *arena = new JSON::_Arena(_size * (sizeof(JSON::_Node) + sizeof(JSON::_String) + 2 * sizeof(JSON::_Slot)));
+
+    try
+    {
+        arena->_adopt(_arena);
+    }
+    catch (...)
+    {
+        delete arena;
+        throw;
+    }
+
+    // The new arena now holds this object's reference to the frozen one
+    try
+    {
+        _share(*this, arena);
+    }
+    catch (...)
+    {
+        _arena->_retain();
+        delete arena;
+        throw;
+    }
+}
+
+// Nested objects that live in a frozen arena are copied into this object's
+// arena, one level at a time, before a pointer to them is handed out. Only
+// the path from the root to the objects actually reached is ever copied.
+JSON::Object *JSON::Object::_child(JSON::_Node *node)
+{
+    JSON::Object *object = node->_object;
+
+    if (object->_arena != NULL && object->_arena->_frozen && _arena != NULL && !_arena->_frozen)
+    {
+        JSON::Object *copy = new (_arena->_allocate(sizeof(JSON::Object), alignof(JSON::Object))) JSON::Object();
+        copy->_share(*object, _arena);
+        node->_object = copy;
+        object = copy;
+    }
+
+    object->_load();
+    return object;
+}
+
+JSON::Object::~Object()
+{
+    _release();
+}
+
+void JSON::Object::_release()
+{
+    if (_mapping != NULL)
+    {
+        delete _mapping;
+    }
+
+    if (_arena != NULL)
+    {
+        // Everything below an arena-backed root lives in the arena
+        if (_owns_arena)
+        {
+            _arena->_release();
+        }
+
+        return;
+    }
+
+    for (size_t i = 0; i < _size; i++)
+    {
+        _free_node(_items[i]);
+
+        if (_keys != NULL)
+        {
+            _free_string(_keys[i]);
+        }
+    }
+
+    delete[] _items;
+    delete[] _keys;
+    delete[] _map;
+
+    if (_pool != NULL)
+    {
+        _pool->_release();
+    }
+}
+
+size_t JSON::Object::size()
+{
+    return _size;
+}
+
+bool JSON::Object::is_array()
+{
+    return _is_array;
+}
+
+JSON::_Node *JSON::Object::_find(const char *key, size_t length, size_t hash)
+{
+    if (_size == 0)
+    {
+        return NULL;
+    }
+
+    size_t mask = _capacity - 1;
+    uint32_t fingerprint = (uint32_t)((uint64_t)hash >> 32);
+
+    for (size_t slot = hash & mask; _map[slot]._node != NULL; slot = (slot + 1) & mask)
+    {
+        JSON::_Slot &entry = _map[slot];
+        if (entry._hash != fingerprint || entry._length != length)
+        {
+            continue;
+        }
+
+        // A key from the pool this object's keys are interned into matches
+        // by address
+        const char *data = _string_data(_keys[entry._node - _items]);
+        if (data == key || memcmp(key, data, length) == 0)
+        {
+            return entry._node;
+        }
+    }
+
+    return NULL;
+}
+
+JSON::_Node *JSON::Object::_get(const char *key, JSON::Type expected_type)
+{
+    if (key == NULL)
+    {
+        throw InvalidKeyException(key);
+    }
+
+    size_t length = strlen(key);
+    return _get(key, length, _is_array ? 0 : _string_hash(key, length), expected_type);
+}
+
+JSON::_Node *JSON::Object::_get(const JSON::Key &key, JSON::Type expected_type)
+{
+    return _get(key.data(), key.size(), key.hash(), expected_type);
+}
+
+JSON::_Node *JSON::Object::_get(const char *key, size_t length, size_t hash, JSON::Type expected_type)
+{
+    JSON::_Node *node;
+    if (_is_array)
+    {
+        size_t index;
+        node = _parse_index(key, length, &index) && index < _size ? &_items[index] : NULL;
+    }
+    else
+    {
+        node = _find(key, length, hash);
+    }
+
+    if (node == NULL)
+    {
+        throw InvalidKeyException(std::string(key, length).c_str());
+    }
+
+    if (node->_type != expected_type && expected_type != JSON::JSON_NULL)
+    {
+        std::string name(key, length);
+        throw WrongTypeException(name, expected_type, node->_type);
+    }
+
+    return node;
+}
+
+std::string &JSON::Object::_materialize(JSON::_String &s)
+{
+    if (s._value == NULL)
+    {
+        s._value = new std::string(s._data, s._length);
+
+        if (_arena != NULL)
+        {
+            _arena->_adopt(s._value);
+        }
+    }
+
+    return *s._value;
+}
+
+// Strings borrowed from the input are followed by their closing quote
+// rather than a NUL, so they are copied before being handed out.
+const char *JSON::Object::_cstring(JSON::_String &s)
+{
+    if (s._value == NULL && s._data[s._length] != '\0')
+    {
+        _materialize(s);
+    }
+
+    return _string_data(s);
+}
+
+JSON::Object *JSON::Object::get_object(const char *key)
+{
+    _own();
+    return _child(_get(key, JSON::OBJECT));
+}
+
+std::string &JSON::Object::get_string(const char *key)
+{
+    _own();
+    return _materialize(_get(key, JSON::STRING)->_string);
+}
+
+const char *JSON::Object::get_cstring(const char *key)
+{
+    return _cstring(_get(key, JSON::STRING)->_string);
+}
+
+JSON::StringView JSON::Object::get_string_view(const char *key)
+{
+    JSON::_String &s = _get(key, JSON::STRING)->_string;
+    return JSON::StringView(_string_data(s), _string_length(s));
+}
+
+double JSON::Object::get_number(const char *key)
+{
+    return _get(key, JSON::NUMBER)->_number;
+}
+
+bool JSON::Object::get_boolean(const char *key)
+{
+    return _get(key, JSON::BOOLEAN)->_boolean;
+}
+
+JSON::Type JSON::Object::get_type(const char *key)
+{
+    return _get(key, JSON::JSON_NULL)->_type;
+}
+
+JSON::Object *JSON::Object::get_object(std::string &key)
+{
+    return get_object(key.c_str());
+}
+
+std::string &JSON::Object::get_string(std::string &key)
+{
+    _own();
+    return _materialize(_get(key.c_str(), JSON::STRING)->_string);
+}
+
+const char *JSON::Object::get_cstring(std::string &key)
+{
+    return get_cstring(key.c_str());
+}
+
+JSON::StringView JSON::Object::get_string_view(std::string &key)
+{
+    return get_string_view(key.c_str());
+}
+
+double JSON::Object::get_number(std::string &key)
+{
+    return _get(key.c_str(), JSON::NUMBER)->_number;
+}
+
+bool JSON::Object::get_boolean(std::string &key)
+{
+    return _get(key.c_str(), JSON::BOOLEAN)->_boolean;
+}
+
+JSON::Type JSON::Object::get_type(std::string &key)
+{
+    return _get(key.c_str(), JSON::JSON_NULL)->_type;
+}
+
+JSON::Object *JSON::Object::get_object(const JSON::Key &key)
+{
+    _own();
+    return _child(_get(key, JSON::OBJECT));
+}
+
+std::string &JSON::Object::get_string(const JSON::Key &key)
+{
+    _own();
+    return _materialize(_get(key, JSON::STRING)->_string);
+}
+
+const char *JSON::Object::get_cstring(const JSON::Key &key)
+{
+    return _cstring(_get(key, JSON::STRING)->_string);
+}
+
+JSON::StringView JSON::Object::get_string_view(const JSON::Key &key)
+{
+    JSON::_String &s = _get(key, JSON::STRING)->_string;
+    return JSON::StringView(_string_data(s), _string_length(s));
+}
+
+double JSON::Object::get_number(const JSON::Key &key)
+{
+    return _get(key, JSON::NUMBER)->_number;
+}
+
+bool JSON::Object::get_boolean(const JSON::Key &key)
+{
+    return _get(key, JSON::BOOLEAN)->_boolean;
+}
+
+JSON::Type JSON::Object::get_type(const JSON::Key &key)
+{
+    return _get(key, JSON::JSON_NULL)->_type;
+}
+
+JSON::_Node *JSON::Object::_get_by_index(int index, JSON::Type expected_type)
+{
+    if (!_is_array)
+    {
+        return _get(std::to_string(index).c_str(), JSON::OBJECT);
+    }
+
+    if (index < 0 || (size_t)index >= _size)
+    {
+        throw InvalidIndexException(index);
+    }
+
+    if (expected_type && _items[index]._type != expected_type)
+    {
+        std::string s = std::to_string(index);
+        throw WrongTypeException(s, expected_type, _items[index]._type);
+    }
+
+    return &_items[index];
+}
+
+JSON::Object *JSON::Object::get_object(int index)
+{
+    _own();
+    return _child(_get_by_index(index, JSON::OBJECT));
+}
+
+std::string &JSON::Object::get_string(int index)
+{
+    _own();
+    return _materialize(_get_by_index(index, JSON::STRING)->_string);
+}
+
+const char *JSON::Object::get_cstring(int index)
+{
+    return _cstring(_get_by_index(index, JSON::STRING)->_string);
+}
+
+JSON::StringView JSON::Object::get_string_view(int index)
+{
+    JSON::_String &s = _get_by_index(index, JSON::STRING)->_string;
+    return JSON::StringView(_string_data(s), _string_length(s));
+}
+
+double JSON::Object::get_number(int index)
+{
+    return _get_by_index(index, JSON::NUMBER)->_number;
+}
+
+bool JSON::Object::get_boolean(int index)
+{
+    return _get_by_index(index, JSON::BOOLEAN)->_boolean;
+}
+
+JSON::Type JSON::Object::get_type(int index)
+{
+    return _get_by_index(index, JSON::JSON_NULL)->_type;
+}
+
+bool JSON::Object::is_object(const char *key)
+{
+    return get_type(key) == JSON::OBJECT;
+}
+
+bool JSON::Object::is_string(const char *key)
+{
+    return get_type(key) == JSON::STRING;
+}
+
+bool JSON::Object::is_number(const char *key)
+{
+    return get_type(key) == JSON::NUMBER;
+}
+
+bool JSON::Object::is_boolean(const char *key)
+{
+    return get_type(key) == JSON::BOOLEAN;
+}
+
+bool JSON::Object::is_null(const char *key)
+{
+    return get_type(key) == JSON::JSON_NULL;
+}
+
+bool JSON::Object::is_object(std::string &key)
+{
+    return get_type(key) == JSON::OBJECT;
+}
+
+bool JSON::Object::is_string(std::string &key)
+{
+    return get_type(key) == JSON::STRING;
+}
+
+bool JSON::Object::is_number(std::string &key)
+{
+    return get_type(key) == JSON::NUMBER;
+}
+
+bool JSON::Object::is_boolean(std::string &key)
+{
+    return get_type(key) == JSON::BOOLEAN;
+}
+
+bool JSON::Object::is_null(std::string &key)
+{
+    return get_type(key) == JSON::JSON_NULL;
+}
+
+bool JSON::Object::is_object(const JSON::Key &key)
+{
+    return get_type(key) == JSON::OBJECT;
+}
+
+bool JSON::Object::is_string(const JSON::Key &key)
+{
+    return get_type(key) == JSON::STRING;
+}
+
+bool JSON::Object::is_number(const JSON::Key &key)
+{
+    return get_type(key) == JSON::NUMBER;
+}
+
+bool JSON::Object::is_boolean(const JSON::Key &key)
+{
+    return get_type(key) == JSON::BOOLEAN;
+}
+
+bool JSON::Object::is_null(const JSON::Key &key)
+{
+    return get_type(key) == JSON::JSON_NULL;
+}
+
+/*
+ * Building
+ *
+ * Values are created before the member that receives them is found, so that
+ * a value taken from the member it replaces is copied before being freed.
+ */
+JSON::Object &JSON::Object::set(const char *key, double value)
+{
+    JSON::_Node node;
+    node._type = JSON::NUMBER;
+    node._number = value;
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, int value)
+{
+    JSON::_Node node;
+    node._type = JSON::NUMBER;
+    node._number = value;
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, bool value)
+{
+    JSON::_Node node;
+    node._type = JSON::BOOLEAN;
+    node._boolean = value;
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, const char *value)
+{
+    JSON::_Node node = _new_string(value);
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, const std::string &value)
+{
+    JSON::_Node node = _new_string(value.data(), value.length());
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, std::nullptr_t)
+{
+    JSON::_Node node;
+    node._type = JSON::JSON_NULL;
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, const JSON::Object &value)
+{
+    JSON::_Node node = _new_object(value);
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(const char *key, JSON::Object &&value)
+{
+    JSON::_Node node = _new_object(std::move(value));
+    return _set(key, node);
+}
+
+JSON::Object &JSON::Object::set(int index, double value)
+{
+    JSON::_Node node;
+    node._type = JSON::NUMBER;
+    node._number = value;
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, int value)
+{
+    JSON::_Node node;
+    node._type = JSON::NUMBER;
+    node._number = value;
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, bool value)
+{
+    JSON::_Node node;
+    node._type = JSON::BOOLEAN;
+    node._boolean = value;
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, const char *value)
+{
+    JSON::_Node node = _new_string(value);
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, const std::string &value)
+{
+    JSON::_Node node = _new_string(value.data(), value.length());
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, std::nullptr_t)
+{
+    JSON::_Node node;
+    node._type = JSON::JSON_NULL;
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, const JSON::Object &value)
+{
+    JSON::_Node node = _new_object(value);
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(int index, JSON::Object &&value)
+{
+    JSON::_Node node = _new_object(std::move(value));
+    return _set(index, node);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, double value)
+{
+    return set(key.c_str(), value);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, int value)
+{
+    return set(key.c_str(), value);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, bool value)
+{
+    return set(key.c_str(), value);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, const char *value)
+{
+    return set(key.c_str(), value);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, const std::string &value)
+{
+    return set(key.c_str(), value);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, std::nullptr_t)
+{
+    return set(key.c_str(), nullptr);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, const JSON::Object &value)
+{
+    return set(key.c_str(), value);
+}
+
+JSON::Object &JSON::Object::set(std::string &key, JSON::Object &&value)
+{
+    return set(key.c_str(), std::move(value));
+}
+
+JSON::Object &JSON::Object::append(double value)
+{
+    JSON::_Node node;
+    node._type = JSON::NUMBER;
+    node._number = value;
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(int value)
+{
+    JSON::_Node node;
+    node._type = JSON::NUMBER;
+    node._number = value;
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(bool value)
+{
+    JSON::_Node node;
+    node._type = JSON::BOOLEAN;
+    node._boolean = value;
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(const char *value)
+{
+    JSON::_Node node = _new_string(value);
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(const std::string &value)
+{
+    JSON::_Node node = _new_string(value.data(), value.length());
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(std::nullptr_t)
+{
+    JSON::_Node node;
+    node._type = JSON::JSON_NULL;
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(const JSON::Object &value)
+{
+    JSON::_Node node = _new_object(value);
+    return _append(node);
+}
+
+JSON::Object &JSON::Object::append(JSON::Object &&value)
+{
+    JSON::_Node node = _new_object(std::move(value));
+    return _append(node);
+}
+
+bool JSON::Object::erase(const char *key)
+{
+    if (key == NULL)
+    {
+        return false;
+    }
+
+    _own();
+    _load();
+
+    if (_is_array)
+    {
+        size_t index;
+        if (!_parse_index(key, strlen(key), &index) || index >= _size)
+        {
+            return false;
+        }
+
+        _remove(index);
+        return true;
+    }
+
+    size_t length = strlen(key);
+    JSON::_Node *node = _find(key, length, _string_hash(key, length));
+    if (node == NULL)
+    {
+        return false;
+    }
+
+    _remove(node - _items);
+    return true;
+}
+
+bool JSON::Object::erase(std::string &key)
+{
+    return erase(key.c_str());
+}
+
+bool JSON::Object::erase(int index)
+{
+    if (!_is_array)
+    {
+        return erase(std::to_string(index).c_str());
+    }
+
+    _own();
+    _load();
+
+    if (index < 0 || (size_t)index >= _size)
+    {
+        return false;
+    }
+
+    _remove(index);
+    return true;
+}
+
+void JSON::Object::_store(JSON::_String *dst, const char *s, size_t length)
+{
+    if (_arena != NULL)
+    {
+        char *p = (char *)_arena->_allocate(length + 1, 1);
+        memcpy(p, s, length);
+        p[length] = '\0';
+
+        dst->_data = p;
+        dst->_length = length;
+        dst->_value = NULL;
+        return;
+    }
+
+    dst->_value = new std::string(s, length);
+    dst->_data = NULL;
+    dst->_length = 0;
+}
+
+JSON::_Node JSON::Object::_new_string(const char *s, size_t length)
+{
+    _own();
+
+    JSON::_Node node;
+    node._type = JSON::STRING;
+    _store(&node._string, s, length);
+    return node;
+}
+
+// A NULL C string is stored as a JSON null rather than as a string.
+JSON::_Node JSON::Object::_new_string(const char *s)
+{
+    if (s == NULL)
+    {
+        JSON::_Node node;
+        node._type = JSON::JSON_NULL;
+        return node;
+    }
+
+    return _new_string(s, strlen(s));
+}
+
+JSON::_Node JSON::Object::_new_object(const JSON::Object &other)
+{
+    _own();
+
+    JSON::_Node node;
+    node._type = JSON::OBJECT;
+
+    if (_arena != NULL)
+    {
+        node._object = new (_arena->_allocate(sizeof(JSON::Object), alignof(JSON::Object))) JSON::Object();
+        node._object->_clone(other, _arena);
+    }
+    else
+    {
+        node._object = new JSON::Object(other);
+    }
+
+    return node;
+}
+
+JSON::_Node JSON::Object::_new_object(JSON::Object &&other)
+{
+    if (_arena != NULL)
+    {
+        return _new_object(other);
+    }
+
+    JSON::_Node node;
+    node._type = JSON::OBJECT;
+    node._object = new JSON::Object(std::move(other));
+    return node;
+}
+
+// Frees a value that is no longer part of this object. Values in an arena
+// go when the arena does.
+void JSON::Object::_discard(JSON::_Node &node)
+{
+    if (_arena == NULL)
+    {
+        _free_node(node);
+    }
+}
+
+// Makes room for more members by doubling the items and keys and building
+// the index again at the new size, so that adding a member takes constant
+// time on average and the index never has to be rebuilt in between.
+void JSON::Object::_grow()
+{
+    size_t allocated = _allocated < 4 ? 4 : _allocated * 2;
+    size_t capacity = _is_array ? 0 : _table_capacity(allocated);
+    JSON::_Node *items = NULL;
+    JSON::_String *keys = NULL;
+    JSON::_Slot *map = NULL;
+
+    if (_arena != NULL)
+    {
+        items = (JSON::_Node *)_arena->_allocate(allocated * sizeof(JSON::_Node), alignof(JSON::_Node));
+        if (!_is_array)
+        {
+            keys = (JSON::_String *)_arena->_allocate(allocated * sizeof(JSON::_String), alignof(JSON::_String));
+            map = (JSON::_Slot *)_arena->_allocate(capacity * sizeof(JSON::_Slot), alignof(JSON::_Slot));
+            memset(map, 0, capacity * sizeof(JSON::_Slot));
+        }
+    }
+    else
+    {
+        try
+        {
+            items = new JSON::_Node[allocated];
+            if (!_is_array)
+            {
+                keys = new JSON::_String[allocated];
+                map = new JSON::_Slot[capacity]();
+            }
+        }
+        catch (...)
+        {
+            delete[] items;
+            delete[] keys;
+            throw;
+        }
+    }
+
+    if (_size != 0)
+    {
+        memcpy(items, _items, _size * sizeof(JSON::_Node));
+        if (!_is_array)
+        {
+            memcpy(keys, _keys, _size * sizeof(JSON::_String));
+        }
+    }
+
+    if (_arena == NULL)
+    {
+        delete[] _items;
+        delete[] _keys;
+        delete[] _map;
+    }
+
+    _items = items;
+    _keys = keys;
+    _map = map;
+    _allocated = allocated;
+    _capacity = capacity;
+
+    if (!_is_array)
+    {
+        _build_index();
+    }
+}
+
+// Returns the member with the given key, releasing its value, or adds one
+// holding null
+JSON::_Node *JSON::Object::_insert(const char *key)
+{
+    if (key == NULL)
+    {
+        throw InvalidKeyException(key);
+    }
+
+    _own();
+    _load();
+
+    JSON::_Node *node;
+    if (_is_array)
+    {
+        size_t index;
+        if (!_parse_index(key, strlen(key), &index) || index >= _size)
+        {
+            throw InvalidKeyException(key);
+        }
+
+        node = &_items[index];
+    }
+    else
+    {
+        size_t length = strlen(key);
+        size_t hash = _string_hash(key, length);
+
+        node = _find(key, length, hash);
+        if (node == NULL)
+        {
+            if (_size == _allocated)
+            {
+                _grow();
+            }
+
+            _store(&_keys[_size], key, length);
+            node = &_items[_size];
+            node->_type = JSON::JSON_NULL;
+            _index(node, hash, length);
+            _size++;
+            return node;
+        }
+    }
+
+    _discard(*node);
+    node->_type = JSON::JSON_NULL;
+    return node;
+}
+
+JSON::Object &JSON::Object::_set(const char *key, JSON::_Node &value)
+{
+    JSON::_Node *node;
+
+    try
+    {
+        node = _insert(key);
+    }
+    catch (...)
+    {
+        _discard(value);
+        throw;
+    }
+
+    *node = value;
+    return *this;
+}
+
+JSON::Object &JSON::Object::_set(int index, JSON::_Node &value)
+{
+    if (!_is_array)
+    {
+        return _set(std::to_string(index).c_str(), value);
+    }
+
+    _own();
+    _load();
+
+    if (index < 0 || (size_t)index >= _size)
+    {
+        _discard(value);
+        throw InvalidIndexException(index);
+    }
+
+    _discard(_items[index]);
+    _items[index] = value;
+    return *this;
+}
+
+JSON::Object &JSON::Object::_append(JSON::_Node &value)
+{
+    _own();
+    _load();
+
+    try
+    {
+        if (!_is_array)
+        {
+            throw NotAnArrayException();
+        }
+
+        if (_size == _allocated)
+        {
+            _grow();
+        }
+    }
+    catch (...)
+    {
+        _discard(value);
+        throw;
+    }
+
+    _items[_size++] = value;
+    return *this;
+}
+
+// Removes the member at index, keeping the others in order
+void JSON::Object::_remove(size_t index)
+{
+    _discard(_items[index]);
+    if (_keys != NULL && _arena == NULL)
+    {
+        _free_string(_keys[index]);
+    }
+
+    size_t after = _size - index - 1;
+    memmove(&_items[index], &_items[index + 1], after * sizeof(JSON::_Node));
+    if (_keys != NULL)
+    {
+        memmove(&_keys[index], &_keys[index + 1], after * sizeof(JSON::_String));
+    }
+
+    _size--;
+
+    if (!_is_array)
+    {
+        memset(_map, 0, _capacity * sizeof(JSON::_Slot));
+        _build_index();
+    }
+}
+
+std::string JSON::Object::to_string()
+{
+    return to_string(0, 0);
+}
+
+std::string JSON::Object::to_string(unsigned int indent)
+{
+    return to_string(indent, 0);
+}
+
+std::string JSON::Object::to_string(unsigned int indent, unsigned int depth)
+{
+    std::string repr;
+    repr.reserve(indent * depth + _estimate(indent, depth));
+    repr.append(indent * depth, ' ');
+
+    JSON::_Writer writer(&repr, indent);
+    _write(&writer, depth);
+    return repr;
+}
+
+void JSON::Object::write(std::string &out, unsigned int indent)
+{
+    JSON::_Writer writer(&out, indent);
+    writer._reserve(_estimate(indent, 0));
+    _write(&writer, 0);
+}
+
+void JSON::Object::write(std::ostream &out, unsigned int indent)
+{
+    write(_ostream_sink, &out, indent);
+}
+
+void JSON::Object::write(JSON::Sink sink, void *context, unsigned int indent)
+{
+    JSON::_Writer writer(sink, context, indent);
+    _write(&writer, 0);
+}
+
+size_t JSON::Object::estimate_size(unsigned int indent)
+{
+    return _estimate(indent, 0);
+}
+
+size_t JSON::Object::_estimate(unsigned int indent, unsigned int depth)
+{
+    _load();
+
+    size_t size = 2 + (indent == 0 ? 0 : 2 + indent * depth);
+
+    for (size_t i = 0; i < _size; i++)
+    {
+        JSON::_Node *node = &_items[i];
+        size += 2 + (indent == 0 ? 0 : 2 + indent * (depth + 1));
+
+        if (!_is_array)
+        {
+            size += _string_length(_keys[i]) + 4;
+        }
+
+        switch (node->_type)
+        {
+        case JSON::OBJECT:
+            size += node->_object->_estimate(indent, depth + 1);
+            break;
+        case JSON::STRING:
+            size += _string_length(node->_string) + 2;
+            break;
+        case JSON::NUMBER:
+            size += 12;
+            break;
+        default:
+            size += 5;
+            break;
+        }
+    }
+
+    return size;
+}
+
+void JSON::Object::_write(JSON::_Writer *writer, unsigned int depth)
+{
+    _load();
+
+    std::string *out = writer->_out;
+
+    if (_size == 0)
+    {
+        out->append(_is_array ? "[]" : "{}", 2);
+        return;
+    }
+
+    *out += _is_array ? '[' : '{';
+
+    for (size_t i = 0; i < _size; i++)
+    {
+        JSON::_Node *node = &_items[i];
+
+        if (i != 0)
+        {
+            out->append(", ", 2);
+        }
+
+        writer->_newline(depth + 1);
+
+        if (!_is_array)
+        {
+            _dump_string(_string_data(_keys[i]), _string_length(_keys[i]), out);
+            out->append(": ", 2);
+        }
+
+        switch (node->_type)
+        {
+        case JSON::JSON_NULL:
+            out->append("null", 4);
+            break;
+        case JSON::OBJECT:
+            node->_object->_write(writer, depth + 1);
+            break;
+        case JSON::STRING:
+            _dump_string(_string_data(node->_string), _string_length(node->_string), out);
+            break;
+        case JSON::NUMBER:
+        {
+            char buf[32];
+            out->append(buf, _format_number(node->_number, buf) - buf);
+            break;
+        }
+        case JSON::BOOLEAN:
+            if (node->_boolean)
+            {
+                out->append("true", 4);
+            }
+            else
+            {
+                out->append("false", 5);
+            }
+            break;
+        default:
+            throw JSON::UnknownInternalException();
+        }
+
+        writer->_flush();
+    }
+
+    writer->_newline(depth);
+    *out += _is_array ? ']' : '}';
+}
+
+JSON::Object::Iterator JSON::Object::begin()
+{
+    return JSON::Object::Iterator(this, 0);
+}
+
+JSON::Object::Iterator JSON::Object::end()
+{
+    return JSON::Object::Iterator(this, _size);
+}
+
+JSON::Object::Iterator::Iterator(JSON::Object *object, size_t index)
+{
+    _object = object;
+    _index = index;
+}
+
+JSON::Object::Iterator &JSON::Object::Iterator::operator++()
+{
+    ++_index;
+    return *this;
+}
+
+JSON::Object::Iterator JSON::Object::Iterator::operator++(int)
+{
+    JSON::Object::Iterator prev = JSON::Object::Iterator(_object, _index);
+    ++(*this);
+    return prev;
+}
+
+bool JSON::Object::Iterator::operator==(const JSON::Object::Iterator &other)
+{
+    return _index == other._index;
+}
+
+bool JSON::Object::Iterator::operator!=(const JSON::Object::Iterator &other)
+{
+    return !(*this == other);
+}
+
+std::string &JSON::Object::Iterator::operator*()
+{
+    if (!_object->_is_array)
+    {
+        _object->_own();
+        return _object->_materialize(_object->_keys[_index]);
+    }
+
+    // Array indices are formatted into the iterator's own buffer
+    _format_index(_index, &_buffer);
+    return _buffer;
+}
+
+JSON::StringView JSON::Object::Iterator::key()
+{
+    if (!_object->_is_array)
+    {
+        JSON::_String &s = _object->_keys[_index];
+        return JSON::StringView(_string_data(s), _string_length(s));
+    }
+
+    _format_index(_index, &_buffer);
+    return JSON::StringView(_buffer.data(), _buffer.length());
+}
+
+/*
+ * MessagePack
+ *
+ * Objects and arrays become maps and arrays, and strings, booleans and null
+ * their MessagePack counterparts. A number is written in the smallest
+ * integer form if it is whole and otherwise as a float32 if that holds it
+ * exactly, so that every value reads back as the same double. Binary and
+ * extension values, and map keys that are not strings, have no place in a
+ * document and are rejected when reading.
+ */
+// Appends the low n bytes of x, most significant first
+void _pack_bytes(std::string *out, uint64_t x, int n)
+{
+    char buf[8];
+    for (int i = n - 1; i >= 0; i--, x >>= 8)
+    {
+        buf[i] = (char)(x & 0xFF);
+    }
+
+    out->append(buf, n);
+}
+
+void _pack_tag(std::string *out, unsigned char tag, uint64_t x, int n)
+{
+    *out += (char)tag;
+    _pack_bytes(out, x, n);
+}
+
+// Strings, arrays and maps share the same size classes. Arrays and maps
+// have no 8-bit form, which tag8 marks with 0.
+void _pack_size(std::string *out, size_t size, unsigned char fix, size_t fix_limit, unsigned char tag8, unsigned char tag16, unsigned char tag32)
+{
+    if (size < fix_limit)
+    {
+        *out += (char)(fix | size);
+    }
+    else if (tag8 != 0 && size <= 0xFF)
+    {
+        _pack_tag(out, tag8, size, 1);
+    }
+    else if (size <= 0xFFFF)
+    {
+        _pack_tag(out, tag16, size, 2);
+    }
+    else
+    {
+        _pack_tag(out, tag32, size, 4);
+    }
+}
+
+void _pack_string(std::string *out, const char *s, size_t length)
+{
+    _pack_size(out, length, 0xA0, 32, 0xD9, 0xDA, 0xDB);
+    out->append(s, length);
+}
+
+void _pack_number(std::string *out, double x)
+{
+    if (x >= 0 && x < 18446744073709551616.0 && x == (double)(uint64_t)x && !(x == 0 && signbit(x)))
+    {
+        uint64_t u = (uint64_t)x;
+        if (u < 0x80)
+        {
+            *out += (char)u;
+        }
+        else if (u <= 0xFF)
+        {
+            _pack_tag(out, 0xCC, u, 1);
+        }
+        else if (u <= 0xFFFF)
+        {
+            _pack_tag(out, 0xCD, u, 2);
+        }
+        else if (u <= 0xFFFFFFFF)
+        {
+            _pack_tag(out, 0xCE, u, 4);
+        }
+        else
+        {
+            _pack_tag(out, 0xCF, u, 8);
+        }
+    }
+    else if (x < 0 && x >= -9223372036854775808.0 && x == (double)(int64_t)x)
+    {
+        int64_t i = (int64_t)x;
+        if (i >= -32)
+        {
+            *out += (char)(i & 0xFF);
+        }
+        else if (i >= INT8_MIN)
+        {
+            _pack_tag(out, 0xD0, (uint64_t)i, 1);
+        }
+        else if (i >= INT16_MIN)
+        {
+            _pack_tag(out, 0xD1, (uint64_t)i, 2);
+        }
+        else if (i >= INT32_MIN)
+        {
+            _pack_tag(out, 0xD2, (uint64_t)i, 4);
+        }
+        else
+        {
+            _pack_tag(out, 0xD3, (uint64_t)i, 8);
+        }
+    }
+    else if (fabs(x) <= FLT_MAX && (double)(float)x == x)
+    {
+        float f = (float)x;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        _pack_tag(out, 0xCA, bits, 4);
+    }
+    else
+    {
+        uint64_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        _pack_tag(out, 0xCB, bits, 8);
+    }
+}
+
+// Reads an n-byte big-endian number at s
+const char *_unpack_bytes(const char *s, const char *end, int n, uint64_t *x)
+{
+    if (!_available(s, end, n))
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    *x = 0;
+    for (int i = 0; i < n; i++)
+    {
+        *x = (*x << 8) | (unsigned char)s[i];
+    }
+
+    return s + n;
+}
+
+// Reads the header of a string at s and returns where its bytes start
+const char *_unpack_string_header(const char *s, const char *end, size_t *length)
+{
+    if (!_available(s, end, 1))
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    unsigned char tag = (unsigned char)*s;
+    uint64_t x;
+    if ((tag & 0xE0) == 0xA0)
+    {
+        x = tag & 0x1F;
+        s++;
+    }
+    else if (tag >= 0xD9 && tag <= 0xDB)
+    {
+        s = _unpack_bytes(s + 1, end, 1 << (tag - 0xD9), &x);
+    }
+    else
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    if (!_available(s, end, x))
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    *length = x;
+    return s;
+}
+
+const char *_unpack_string(const char *s, JSON::_Context *ctx, JSON::_String *dst)
+{
+    size_t length;
+    s = _unpack_string_header(s, ctx->_end, &length);
+
+    // A view must not end at the end of the input, where get_cstring()
+    // would look for a terminator past it
+    if ((ctx->_mode & JSON::PARSE_ZERO_COPY) && s + length != ctx->_end)
+    {
+        dst->_data = s;
+        dst->_length = length;
+        dst->_value = NULL;
+    }
+    else
+    {
+        ctx->_store(dst, s, length);
+    }
+
+    return s + length;
+}
+
+std::string JSON::Object::to_msgpack()
+{
+    std::string out;
+    write_msgpack(out);
+    return out;
+}
+
+void JSON::Object::write_msgpack(std::string &out)
+{
+    JSON::_Writer writer(&out, 0);
+    writer._reserve(_estimate(0, 0));
+    _pack(&writer);
+}
+
+void JSON::Object::write_msgpack(std::ostream &out)
+{
+    write_msgpack(_ostream_sink, &out);
+}
+
+void JSON::Object::write_msgpack(JSON::Sink sink, void *context)
+{
+    JSON::_Writer writer(sink, context, 0);
+    _pack(&writer);
+}
+
+void JSON::Object::_pack(JSON::_Writer *writer)
+{
+    _load();
+
+    std::string *out = writer->_out;
+
+    if (_is_array)
+    {
+        _pack_size(out, _size, 0x90, 16, 0, 0xDC, 0xDD);
+    }
+    else
+    {
+        _pack_size(out, _size, 0x80, 16, 0, 0xDE, 0xDF);
+    }
+
+    for (size_t i = 0; i < _size; i++)
+    {
+        JSON::_Node *node = &_items[i];
+
+        if (!_is_array)
+        {
+            _pack_string(out, _string_data(_keys[i]), _string_length(_keys[i]));
+        }
+
+        switch (node->_type)
+        {
+        case JSON::JSON_NULL:
+            *out += (char)0xC0;
+            break;
+        case JSON::OBJECT:
+            node->_object->_pack(writer);
+            break;
+        case JSON::STRING:
+            _pack_string(out, _string_data(node->_string), _string_length(node->_string));
+            break;
+        case JSON::NUMBER:
+            _pack_number(out, node->_number);
+            break;
+        case JSON::BOOLEAN:
+            *out += (char)(node->_boolean ? 0xC3 : 0xC2);
+            break;
+        default:
+            throw JSON::UnknownInternalException();
+        }
+
+        writer->_flush();
+    }
+}
+
+// Only PARSE_ARENA, PARSE_ZERO_COPY and PARSE_INTERN_KEYS apply to
+// MessagePack. Zero-copy documents point into data for their strings,
+// which need no unescaping.
+JSON::Object JSON::Object::from_msgpack(const char *data, size_t length, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    JSON::Object object;
+    object._unpack(data, data + length, mode, stats, NULL);
+    return object;
+}
+
+JSON::Object JSON::Object::from_msgpack(std::string &data, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    return from_msgpack(data.data(), data.length(), mode, stats);
+}
+
+JSON::Object JSON::Object::from_msgpack(const char *data, size_t length, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    JSON::Object object;
+    object._unpack(data, data + length, mode, stats, pool._pool);
+    return object;
+}
+
+JSON::Object JSON::Object::from_msgpack(std::string &data, JSON::KeyPool &pool, JSON::ParseMode mode, JSON::ParseStats *stats)
+{
+    return from_msgpack(data.data(), data.length(), pool, mode, stats);
+}
+
+void JSON::Object::_unpack(const char *s, const char *end, JSON::ParseMode mode, JSON::ParseStats *stats, JSON::_KeyPool *pool)
+{
+    if (s == NULL)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    mode = (JSON::ParseMode)(mode & (JSON::PARSE_ARENA | JSON::PARSE_ZERO_COPY | JSON::PARSE_INTERN_KEYS));
+
+    JSON::_KeyPool *keys = _open_pool(pool, mode);
+    JSON::_Arena *arena = NULL;
+    if (mode & JSON::PARSE_ARENA)
+    {
+        // MessagePack is denser than text, so nodes take up more per byte
+        try
+        {
+            arena = new JSON::_Arena((end - s) * 4);
+        }
+        catch (...)
+        {
+            if (keys != NULL)
+            {
+                keys->_release();
+            }
+            throw;
+        }
+
+        arena->_borrows = (mode & JSON::PARSE_ZERO_COPY) != 0;
+        arena->_pool = keys;
+    }
+
+    JSON::_Context ctx(arena, mode, end);
+    ctx._pool = keys;
+    if (keys != NULL && pool == NULL)
+    {
+        ctx._allocations += 2;
+        ctx._bytes += keys->_bytes;
+    }
+
+    try
+    {
+        if (_unpack(s, &ctx) != end)
+        {
+            throw JSON::DecodeException(0);
+        }
+    }
+    catch (...)
+    {
+        _release();
+        delete arena;
+
+        if (keys != NULL && arena == NULL)
+        {
+            keys->_release();
+        }
+
+        // Leave an empty object for the destructor of a factory's result
+        _size = 0;
+        _items = NULL;
+        _keys = NULL;
+        _map = NULL;
+        _arena = NULL;
+        throw;
+    }
+
+    _owns_arena = arena != NULL;
+    _pool = keys;
+    ctx._report(stats);
+}
+
+const char *JSON::Object::_unpack(const char *s, JSON::_Context *ctx)
+{
+    _arena = ctx->_arena;
+    size_t base = ctx->_nodes.size();
+    size_t key_base = ctx->_keys.size();
+
+    try
+    {
+        if (!_available(s, ctx->_end, 1))
+        {
+            throw JSON::DecodeException(0);
+        }
+
+        unsigned char tag = (unsigned char)*s;
+        uint64_t count;
+        if ((tag & 0xE0) == 0x80)
+        {
+            _is_array = (tag & 0x10) != 0;
+            count = tag & 0x0F;
+            s++;
+        }
+        else if (tag >= 0xDC && tag <= 0xDF)
+        {
+            _is_array = tag <= 0xDD;
+            s = _unpack_bytes(s + 1, ctx->_end, (tag & 1) ? 4 : 2, &count);
+        }
+        else
+        {
+            throw JSON::DecodeException(0);
+        }
+
+        for (uint64_t i = 0; i < count; i++)
+        {
+            if (!_is_array && ctx->_pool != NULL)
+            {
+                size_t length;
+                s = _unpack_string_header(s, ctx->_end, &length);
+                ctx->_push_key(s, length);
+                s += length;
+            }
+            else if (!_is_array)
+            {
+                JSON::_String key;
+                s = _unpack_string(s, ctx, &key);
+                ctx->_push(ctx->_keys, key);
+            }
+
+            JSON::_Node null_node;
+            null_node._type = JSON::JSON_NULL;
+            ctx->_push(ctx->_nodes, null_node);
+            s = _unpack_value(s, &ctx->_nodes.back(), ctx);
+        }
+    }
+    catch (...)
+    {
+        ctx->_unwind(base, key_base);
+        throw;
+    }
+
+    _assemble(ctx, base, key_base);
+    return s;
+}
+
+const char *JSON::Object::_unpack_value(const char *s, JSON::_Node *node, JSON::_Context *ctx)
+{
+    if (!_available(s, ctx->_end, 1))
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    unsigned char tag = (unsigned char)*s;
+    uint64_t x;
+
+    if (tag < 0x80)
+    {
+        node->_type = JSON::NUMBER;
+        node->_number = tag;
+        return s + 1;
+    }
+
+    if (tag >= 0xE0)
+    {
+        node->_type = JSON::NUMBER;
+        node->_number = (int)tag - 256;
+        return s + 1;
+    }
+
+    if ((tag & 0xE0) == 0x80 || (tag >= 0xDC && tag <= 0xDF))
+    {
+        // The node owns the child before it is read, as in _value()
+        JSON::Object *child = ctx->_new_object();
+        node->_object = child;
+        node->_type = JSON::OBJECT;
+        return child->_unpack(s, ctx);
+    }
+
+    if ((tag & 0xE0) == 0xA0 || (tag >= 0xD9 && tag <= 0xDB))
+    {
+        s = _unpack_string(s, ctx, &node->_string);
+        node->_type = JSON::STRING;
+        return s;
+    }
+
+    switch (tag)
+    {
+    case 0xC0:
+        node->_type = JSON::JSON_NULL;
+        return s + 1;
+    case 0xC2:
+    case 0xC3:
+        node->_type = JSON::BOOLEAN;
+        node->_boolean = tag == 0xC3;
+        return s + 1;
+    case 0xCA:
+    {
+        s = _unpack_bytes(s + 1, ctx->_end, 4, &x);
+        uint32_t bits = (uint32_t)x;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        node->_type = JSON::NUMBER;
+        node->_number = f;
+        return s;
+    }
+    case 0xCB:
+        s = _unpack_bytes(s + 1, ctx->_end, 8, &x);
+        node->_type = JSON::NUMBER;
+        memcpy(&node->_number, &x, sizeof(x));
+        return s;
+    case 0xCC:
+    case 0xCD:
+    case 0xCE:
+    case 0xCF:
+        s = _unpack_bytes(s + 1, ctx->_end, 1 << (tag - 0xCC), &x);
+        node->_type = JSON::NUMBER;
+        node->_number = (double)x;
+        return s;
+    case 0xD0:
+    case 0xD1:
+    case 0xD2:
+    case 0xD3:
+    {
+        int n = 1 << (tag - 0xD0);
+        s = _unpack_bytes(s + 1, ctx->_end, n, &x);
+
+        // Sign-extend from n bytes
+        if (n < 8 && (x >> (8 * n - 1)) != 0)
+        {
+            x |= ~(uint64_t)0 << (8 * n);
+        }
+
+        node->_type = JSON::NUMBER;
+        node->_number = (double)(int64_t)x;
+        return s;
+    }
+    default:
+        throw JSON::DecodeException(0);
+    }
+}
+
+/*
+ * Path
+ *
+ * A JSON Pointer (RFC 6901) split into unescaped reference tokens. Each token
+ * is kept NUL-terminated in one buffer along with its hash and, if it is one,
+ * its value as an array index, so that following a path needs no hashing,
+ * parsing or allocation.
+ */
+JSON::Path::Path(const char *pointer)
+{
+    _parse(pointer);
+}
+
+JSON::Path::Path(std::string &pointer)
+{
+    _parse(pointer.c_str());
+}
+
+void JSON::Path::_parse(const char *pointer)
+{
+    if (pointer == NULL || (*pointer != '\0' && *pointer != '/'))
+    {
+        throw JSON::InvalidPathException(pointer);
+    }
+
+    const char *s = pointer;
+    while (*s == '/')
+    {
+        s++;
+
+        JSON::_Step step;
+        step._offset = _tokens.length();
+
+        for (; *s != '\0' && *s != '/'; s++)
+        {
+            if (*s != '~')
+            {
+                _tokens += *s;
+            }
+            else if (s[1] == '0' || s[1] == '1')
+            {
+                _tokens += *++s == '0' ? '~' : '/';
+            }
+            else
+            {
+                throw JSON::InvalidPathException(pointer);
+            }
+        }
+
+        step._length = _tokens.length() - step._offset;
+        _tokens += '\0';
+        _steps.push_back(step);
+    }
+
+    // Pointers into the buffer are only taken once it has stopped growing
+    for (auto &step : _steps)
+    {
+        const char *token = _tokens.data() + step._offset;
+        step._hash = _string_hash(token, step._length);
+        if (!_parse_index(token, step._length, &step._index))
+        {
+            step._index = (size_t)-1;
+        }
+    }
+}
+
+size_t JSON::Path::size() const
+{
+    return _steps.size();
+}
+
+// Follows the path from *object. On success, *object is the object or array
+// holding *node, or the document itself if the path is empty and *node is
+// NULL. Objects are only copied out of a shared arena when a pointer to one
+// is going to be handed out.
+JSON::PathStatus JSON::Path::_resolve(JSON::Object **object, JSON::_Node **node, bool own) const
+{
+    JSON::Object *current = *object;
+    JSON::_Node *found = NULL;
+
+    if (own)
+    {
+        current->_own();
+    }
+
+    for (auto &step : _steps)
+    {
+        if (found != NULL)
+        {
+            if (found->_type != JSON::OBJECT)
+            {
+                return JSON::PATH_NOT_FOUND;
+            }
+
+            if (own)
+            {
+                current = current->_child(found);
+            }
+            else
+            {
+                current = found->_object;
+                current->_load();
+            }
+        }
+
+        if (current->_is_array)
+        {
+            found = step._index < current->_size ? &current->_items[step._index] : NULL;
+        }
+        else
+        {
+            found = current->_find(_tokens.data() + step._offset, step._length, step._hash);
+        }
+
+        if (found == NULL)
+        {
+            return JSON::PATH_NOT_FOUND;
+        }
+    }
+
+    *object = current;
+    *node = found;
+    return JSON::PATH_OK;
+}
+
+JSON::PathStatus JSON::Path::_resolve(JSON::Object &document, JSON::Type type, JSON::_Node **node) const
+{
+    JSON::Object *object = &document;
+    JSON::PathStatus status = _resolve(&object, node, false);
+
+    if (status == JSON::PATH_OK && (*node == NULL ? JSON::OBJECT : (*node)->_type) != type)
+    {
+        return JSON::PATH_WRONG_TYPE;
+    }
+
+    return status;
+}
+
+JSON::PathStatus JSON::Path::get_object(JSON::Object &document, JSON::Object **value) const
+{
+    JSON::Object *object = &document;
+    JSON::_Node *node;
+
+    JSON::PathStatus status = _resolve(&object, &node, true);
+    if (status != JSON::PATH_OK)
+    {
+        return status;
+    }
+
+    if (node == NULL)
+    {
+        *value = object;
+        return JSON::PATH_OK;
+    }
+
+    if (node->_type != JSON::OBJECT)
+    {
+        return JSON::PATH_WRONG_TYPE;
+    }
+
+    *value = object->_child(node);
+    return JSON::PATH_OK;
+}
+
+JSON::PathStatus JSON::Path::get_string_view(JSON::Object &document, JSON::StringView *value) const
+{
+    JSON::_Node *node;
+
+    JSON::PathStatus status = _resolve(document, JSON::STRING, &node);
+    if (status == JSON::PATH_OK)
+    {
+        *value = JSON::StringView(_string_data(node->_string), _string_length(node->_string));
+    }
+
+    return status;
+}
+
+JSON::PathStatus JSON::Path::get_number(JSON::Object &document, double *value) const
+{
+    JSON::_Node *node;
+
+    JSON::PathStatus status = _resolve(document, JSON::NUMBER, &node);
+    if (status == JSON::PATH_OK)
+    {
+        *value = node->_number;
+    }
+
+    return status;
+}
+
+JSON::PathStatus JSON::Path::get_boolean(JSON::Object &document, bool *value) const
+{
+    JSON::_Node *node;
+
+    JSON::PathStatus status = _resolve(document, JSON::BOOLEAN, &node);
+    if (status == JSON::PATH_OK)
+    {
+        *value = node->_boolean;
+    }
+
+    return status;
+}
+
+JSON::PathStatus JSON::Path::get_type(JSON::Object &document, JSON::Type *value) const
+{
+    JSON::Object *object = &document;
+    JSON::_Node *node;
+
+    JSON::PathStatus status = _resolve(&object, &node, false);
+    if (status == JSON::PATH_OK)
+    {
+        *value = node == NULL ? JSON::OBJECT : node->_type;
+    }
+
+    return status;
+}
+
+/*
+ * StringView
+ */
+JSON::StringView::StringView()
+{
+    _data = "";
+    _length = 0;
+}
+
+JSON::StringView::StringView(const char *data, size_t length)
+{
+    _data = data;
+    _length = length;
+}
+
+const char *JSON::StringView::data() const
+{
+    return _data;
+}
+
+size_t JSON::StringView::size() const
+{
+    return _length;
+}
+
+size_t JSON::StringView::length() const
+{
+    return _length;
+}
+
+std::string JSON::StringView::str() const
+{
+    return std::string(_data, _length);
+}
+
+bool JSON::StringView::operator==(const JSON::StringView &other) const
+{
+    return _length == other._length && memcmp(_data, other._data, _length) == 0;
+}
+
+bool JSON::StringView::operator==(const char *other) const
+{
+    size_t length = strlen(other);
+    return length == _length && memcmp(_data, other, length) == 0;
+}
+
+bool JSON::StringView::operator!=(const JSON::StringView &other) const
+{
+    return !(*this == other);
+}
+
+bool JSON::StringView::operator!=(const char *other) const
+{
+    return !(*this == other);
+}
+
+/*
+ * Tape
+ *
+ * A Document stores its tree as one array of 64-bit words, each tagged in
+ * its top byte with a character naming the kind of value:
+ *
+ *   '{' '['  opening word, payload is the index just past the closing word
+ *   '}' ']'  closing word, payload is the number of elements
+ *   '"'      string, payload is an offset into the string buffer
+ *   'd'      number, the next word holds the bits of the double
+ *   't' 'f' 'n'
+ *
+ * Object members are a string word for the key followed by the value. The
+ * string buffer stores each string as a 64-bit length, the bytes and a NUL.
+ */
+uint64_t _tape_word(char tag, uint64_t payload)
+{
+    return ((uint64_t)(unsigned char)tag << 56) | payload;
+}
+
+char _tape_tag(uint64_t word)
+{
+    return (char)(word >> 56);
+}
+
+uint64_t _tape_payload(uint64_t word)
+{
+    return word & (((uint64_t)1 << 56) - 1);
+}
+
+// Index of the word after the value starting at i
+size_t _tape_next(const uint64_t *tape, size_t i)
+{
+    switch (_tape_tag(tape[i]))
+    {
+    case '{':
+    case '[':
+        return (size_t)_tape_payload(tape[i]);
+    case 'd':
+        return i + 2;
+    default:
+        return i + 1;
+    }
+}
+
+double _tape_number(const uint64_t *tape, size_t i)
+{
+    double x;
+    memcpy(&x, &tape[i + 1], sizeof(x));
+    return x;
+}
+
+JSON::Type _tape_type(uint64_t word)
+{
+    switch (_tape_tag(word))
+    {
+    case '{':
+    case '[':
+        return JSON::OBJECT;
+    case '"':
+        return JSON::STRING;
+    case 'd':
+        return JSON::NUMBER;
+    case 't':
+    case 'f':
+        return JSON::BOOLEAN;
+    default:
+        return JSON::JSON_NULL;
+    }
+}
+
+class JSON::_TapeBuilder
+{
+public:
+    const char *_end;
+    int _line;
+    std::vector<uint64_t> _tape;
+    std::string _strings;
+    std::string _buffer;
+
+    _TapeBuilder(const char *);
+    void _push_string();
+    void _push_string(const char *, size_t);
+    const char *_container(const char *);
+};
+
+JSON::_TapeBuilder::_TapeBuilder(const char *end)
+{
+    _end = end;
+    _line = 1;
+}
+
+// Moves the string just decoded into _buffer onto the tape
+void JSON::_TapeBuilder::_push_string()
+{
+    _push_string(_buffer.c_str(), _buffer.length());
+}
+
+void JSON::_TapeBuilder::_push_string(const char *s, size_t length)
+{
+    uint64_t n = length;
+
+    _tape.push_back(_tape_word('"', _strings.length()));
+    _strings.append((const char *)&n, sizeof(n));
+    _strings.append(s, length);
+    _strings += '\0';
+}
+
+const char *JSON::_TapeBuilder::_container(const char *s)
+{
+    bool is_array = *s == '[';
+    size_t open = _tape.size();
+    size_t count = 0;
+
+    _tape.push_back(0);
+
+    s = _consume_whitespace(s + 1, _end, &_line);
+    if (_peek(s, _end) != (is_array ? ']' : '}'))
+    {
+        while (true)
+        {
+            s = _consume_whitespace(s, _end, &_line);
+
+            // Parse key
+            if (!is_array)
+            {
+                if (_peek(s, _end) != '"')
+                {
+                    throw JSON::DecodeException(_line);
+                }
+
+                s = _consume_string(s, _end, &_buffer, _line);
+                _push_string();
+                s = _consume_whitespace(s, _end, &_line);
+                if (_peek(s, _end) != ':')
+                {
+                    throw JSON::DecodeException(_line);
+                }
+                else
+                {
+                    s = _consume_whitespace(s + 1, _end, &_line);
+                }
+            }
+
+            // Parse value
+            switch (_peek(s, _end))
+            {
+            case 't':
+                s = _CONSUME_TRUE(s, _end, _line);
+                _tape.push_back(_tape_word('t', 0));
+                break;
+            case 'f':
+                s = _CONSUME_FALSE(s, _end, _line);
+                _tape.push_back(_tape_word('f', 0));
+                break;
+            case 'n':
+                s = _CONSUME_NULL(s, _end, _line);
+                _tape.push_back(_tape_word('n', 0));
+                break;
+            case '"':
+                s = _consume_string(s, _end, &_buffer, _line);
+                _push_string();
+                break;
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            case '-':
+            {
+                double x;
+                uint64_t bits;
+                s = _consume_number(s, _end, &x, _line);
+                memcpy(&bits, &x, sizeof(bits));
+                _tape.push_back(_tape_word('d', 0));
+                _tape.push_back(bits);
+                break;
+            }
+            case '{':
+            case '[':
+                s = _container(s);
+                break;
+            default:
+                throw JSON::DecodeException(_line);
+            }
+
+            count++;
+
+            s = _consume_whitespace(s, _end, &_line);
+            if (_peek(s, _end) == (is_array ? ']' : '}'))
+            {
+                s++;
+                break;
+            }
+            else if (_peek(s, _end) == ',')
+            {
+                s++;
+            }
+            else
+            {
+                throw JSON::DecodeException(_line);
+            }
+        }
+    }
+    else
+    {
+        s++;
+    }
+
+    _tape[open] = _tape_word(is_array ? '[' : '{', _tape.size() + 1);
+    _tape.push_back(_tape_word(is_array ? ']' : '}', count));
+    return s;
+}
+
+/*
+ * Document
+ */
+JSON::Document::Document()
+{
+    _tape = NULL;
+    _tape_size = 0;
+    _strings = NULL;
+    _strings_size = 0;
+    _index = NULL;
+    _index_size = 0;
+    _mapping = NULL;
+}
+
+JSON::Document::Document(const char *s)
+{
+    _parse(s, NULL);
+}
+
+JSON::Document::Document(std::string &s)
+{
+    _parse(s.c_str(), NULL);
+}
+
+JSON::Document::Document(const char *data, size_t length)
+{
+    _parse(data, data + length);
+}
+
+void JSON::Document::_parse(const char *s, const char *end)
+{
+    _tape = NULL;
+    _tape_size = 0;
+    _strings = NULL;
+    _strings_size = 0;
+    _index = NULL;
+    _index_size = 0;
+    _mapping = NULL;
+
+    if (s == NULL)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    JSON::_TapeBuilder builder(end != NULL ? end : _no_end);
+    s = _consume_whitespace(s, builder._end, &builder._line);
+    if (_peek(s, builder._end) != '{' && _peek(s, builder._end) != '[')
+    {
+        throw JSON::DecodeException(builder._line);
+    }
+
+    s = builder._container(s);
+
+    if (end != NULL && _consume_whitespace(s, end, &builder._line) != end)
+    {
+        throw JSON::DecodeException(builder._line);
+    }
+
+    _adopt(&builder);
+}
+
+void JSON::Document::_adopt(JSON::_TapeBuilder *builder)
+{
+    _tape_size = builder->_tape.size();
+    _tape = new uint64_t[_tape_size];
+    memcpy(_tape, builder->_tape.data(), _tape_size * sizeof(uint64_t));
+
+    _strings_size = builder->_strings.length();
+    _strings = new char[_strings_size];
+    memcpy(_strings, builder->_strings.data(), _strings_size);
+}
+
+JSON::Document::Document(JSON::Object &object) : Document()
+{
+    JSON::_TapeBuilder builder(_no_end);
+    object._tape(&builder);
+    _adopt(&builder);
+}
+
+// A copy always lives on the heap, even when the original is a snapshot
+JSON::Document::Document(const JSON::Document &other) : Document()
+{
+    _tape_size = other._tape_size;
+    _tape = new uint64_t[_tape_size];
+    memcpy(_tape, other._tape, _tape_size * sizeof(uint64_t));
+
+    _strings_size = other._strings_size;
+    _strings = new char[_strings_size];
+    memcpy(_strings, other._strings, _strings_size);
+
+    if (other._index != NULL)
+    {
+        _index_size = other._index_size;
+        _index = new uint64_t[_index_size];
+        memcpy(_index, other._index, _index_size * sizeof(uint64_t));
+    }
+}
+
+JSON::Document::Document(JSON::Document &&other) noexcept
+{
+    _tape = other._tape;
+    _tape_size = other._tape_size;
+    _strings = other._strings;
+    _strings_size = other._strings_size;
+    _index = other._index;
+    _index_size = other._index_size;
+    _mapping = other._mapping;
+
+    other._tape = NULL;
+    other._tape_size = 0;
+    other._strings = NULL;
+    other._strings_size = 0;
+    other._index = NULL;
+    other._index_size = 0;
+    other._mapping = NULL;
+}
+
+JSON::Document::~Document()
+{
+    // A snapshot points into its mapping
+    if (_mapping != NULL)
+    {
+        delete _mapping;
+        return;
+    }
+
+    delete[] _tape;
+    delete[] _strings;
+    delete[] _index;
+}
+
+JSON::View JSON::Document::root() const
+{
+    return JSON::View(this, 0);
+}
+
+void JSON::Object::_tape(JSON::_TapeBuilder *builder)
+{
+    _load();
+
+    std::vector<uint64_t> &tape = builder->_tape;
+    size_t open = tape.size();
+    tape.push_back(0);
+
+    for (size_t i = 0; i < _size; i++)
+    {
+        JSON::_Node *node = &_items[i];
+
+        if (!_is_array)
+        {
+            builder->_push_string(_string_data(_keys[i]), _string_length(_keys[i]));
+        }
+
+        switch (node->_type)
+        {
+        case JSON::JSON_NULL:
+            tape.push_back(_tape_word('n', 0));
+            break;
+        case JSON::OBJECT:
+            node->_object->_tape(builder);
+            break;
+        case JSON::STRING:
+            builder->_push_string(_string_data(node->_string), _string_length(node->_string));
+            break;
+        case JSON::NUMBER:
+        {
+            uint64_t bits;
+            memcpy(&bits, &node->_number, sizeof(bits));
+            tape.push_back(_tape_word('d', 0));
+            tape.push_back(bits);
+            break;
+        }
+        case JSON::BOOLEAN:
+            tape.push_back(_tape_word(node->_boolean ? 't' : 'f', 0));
+            break;
+        default:
+            throw JSON::UnknownInternalException();
+        }
+    }
+
+    tape[open] = _tape_word(_is_array ? '[' : '{', tape.size() + 1);
+    tape.push_back(_tape_word(_is_array ? ']' : '}', _size));
+}
+
+void JSON::Object::write_snapshot(const char *path)
+{
+    JSON::Document(*this).write_snapshot(path);
+}
+
+void JSON::Object::write_snapshot(std::string &path)
+{
+    write_snapshot(path.c_str());
+}
+
+/*
+ * Snapshot
+ *
+ * A Document written out as it is held in memory, so that it can be mapped
+ * and used in place. The file is a header of five words (the bytes
+ * "JSONSNP1", a byte order mark, and the tape, string and index sizes),
+ * the tape, the string buffer padded to a whole word, and the index.
+ *
+ * The index holds a table for every object and array, and the closing word
+ * of each points at its table instead of holding the element count. Each
+ * table starts with the count and a capacity. An object's table is then an
+ * open-addressing hash table with a slot per capacity, each slot holding
+ * the high half of the key's hash above the key's position relative to the
+ * opening word. An array's table holds the positions of its elements, two
+ * to a word. A capacity of 0 means there is no table, as for containers
+ * too large for 32-bit positions, which are searched as in other documents.
+ */
+const uint64_t _snapshot_byte_order = 0x0102030405060708ull;
+
+void _build_tables(uint64_t *tape, size_t size, const char *strings, std::vector<uint64_t> *index)
+{
+    for (size_t i = 0; i < size; i += _tape_tag(tape[i]) == 'd' ? 2 : 1)
+    {
+        char tag = _tape_tag(tape[i]);
+        if (tag != '{' && tag != '[')
+        {
+            continue;
+        }
+
+        size_t close = (size_t)_tape_payload(tape[i]) - 1;
+        uint64_t count = _tape_payload(tape[close]);
+        size_t table = index->size();
+        bool small = close - i <= 0xFFFFFFFF;
+
+        index->push_back(count);
+        if (tag == '[')
+        {
+            index->push_back(small ? count : 0);
+            if (small)
+            {
+                index->resize(table + 2 + (count + 1) / 2, 0);
+
+                size_t k = 0;
+                for (size_t j = i + 1; j < close; j = _tape_next(tape, j), k++)
+                {
+                    (*index)[table + 2 + k / 2] |= (uint64_t)(j - i) << (32 * (k & 1));
+                }
+            }
+        }
+        else
+        {
+            size_t capacity = small ? _table_capacity((size_t)count) : 0;
+            index->push_back(capacity);
+            index->resize(table + 2 + capacity, 0);
+
+            for (size_t j = i + 1; capacity != 0 && j < close; j = _tape_next(tape, j + 1))
+            {
+                const char *key = strings + _tape_payload(tape[j]);
+                uint64_t length;
+                memcpy(&length, key, sizeof(length));
+
+                size_t hash = _string_hash(key + sizeof(length), (size_t)length);
+                size_t slot = hash & (capacity - 1);
+                while ((*index)[table + 2 + slot] != 0)
+                {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+
+                (*index)[table + 2 + slot] = ((uint64_t)hash >> 32 << 32) | (j - i);
+            }
+        }
+
+        tape[close] = _tape_word(_tape_tag(tape[close]), table);
+    }
+}
+
+void JSON::Document::write_snapshot(const char *path) const
+{
+    if (path == NULL)
+    {
+        throw JSON::FileException(path);
+    }
+
+    const uint64_t *tape = _tape;
+    const uint64_t *index = _index;
+    size_t index_size = _index_size;
+
+    std::vector<uint64_t> tape_copy;
+    std::vector<uint64_t> tables;
+    if (_index == NULL)
+    {
+        tape_copy.assign(_tape, _tape + _tape_size);
+        _build_tables(tape_copy.data(), _tape_size, _strings, &tables);
+        tape = tape_copy.data();
+        index = tables.data();
+        index_size = tables.size();
+    }
+
+    uint64_t header[5];
+    memcpy(&header[0], "JSONSNP1", sizeof(header[0]));
+    header[1] = _snapshot_byte_order;
+    header[2] = _tape_size;
+    header[3] = _strings_size;
+    header[4] = index_size;
+
+    const char padding[8] = {0};
+    size_t pad = (8 - _strings_size % 8) % 8;
+
+    // Written beside the destination and renamed over it, so that processes
+    // with the old snapshot mapped keep a consistent view of it
+    std::string temporary = std::string(path) + ".tmp";
+    FILE *f = fopen(temporary.c_str(), "wb");
+    if (f == NULL)
+    {
+        throw JSON::FileException(path);
+    }
+
+    bool written = fwrite(header, sizeof(header), 1, f) == 1 &&
+                   fwrite(tape, sizeof(uint64_t), _tape_size, f) == _tape_size &&
+                   fwrite(_strings, 1, _strings_size, f) == _strings_size &&
+                   fwrite(padding, 1, pad, f) == pad &&
+                   fwrite(index, sizeof(uint64_t), index_size, f) == index_size;
+
+    if (fclose(f) != 0 || !written || rename(temporary.c_str(), path) != 0)
+    {
+        remove(temporary.c_str());
+        throw JSON::FileException(path);
+    }
+}
+
+void JSON::Document::write_snapshot(std::string &path) const
+{
+    write_snapshot(path.c_str());
+}
+
+// Only the header is checked, so that opening a snapshot takes the same
+// time whatever its size. The rest is trusted as this library wrote it.
+JSON::Document JSON::Document::from_snapshot(const char *path)
+{
+    JSON::Document document;
+    document._mapping = new JSON::_Mapping(path, false);
+
+    const char *data = document._mapping->_data;
+    uint64_t rest = document._mapping->_length;
+    uint64_t header[5];
+
+    if (rest < sizeof(header) || memcmp(data, "JSONSNP1", 8) != 0)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    memcpy(header, data, sizeof(header));
+    rest -= sizeof(header);
+
+    uint64_t tape_size = header[2];
+    uint64_t strings_size = header[3];
+    uint64_t index_size = header[4];
+    uint64_t pad = (8 - strings_size % 8) % 8;
+
+    if (header[1] != _snapshot_byte_order || tape_size < 2 || tape_size > rest / 8)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    rest -= tape_size * 8;
+    if (strings_size > rest || pad > rest - strings_size || rest - strings_size - pad != index_size * 8 || index_size < 2)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    document._tape = (uint64_t *)(data + sizeof(header));
+    document._tape_size = (size_t)tape_size;
+    document._strings = (char *)(data + sizeof(header) + tape_size * 8);
+    document._strings_size = (size_t)strings_size;
+    document._index = (uint64_t *)(data + sizeof(header) + tape_size * 8 + strings_size + pad);
+    document._index_size = (size_t)index_size;
+
+    char tag = _tape_tag(document._tape[0]);
+    if ((tag != '{' && tag != '[') || _tape_payload(document._tape[0]) != tape_size)
+    {
+        throw JSON::DecodeException(0);
+    }
+
+    return document;
+}
+
+JSON::Document JSON::Document::from_snapshot(std::string &path)
+{
+    return from_snapshot(path.c_str());
+}
+
+/*
+ * View
+ */
+JSON::View::View(const JSON::Document *document, size_t word)
+{
+    _document = document;
+    _word = word;
+    _cursor = word + 1;
+    _cursor_index = 0;
+}
+
+size_t JSON::View::size() const
+{
+    if (_document->_index != NULL)
+    {
+        return (size_t)_table()[0];
+    }
+
+    const uint64_t *tape = _document->_tape;
+    return (size_t)_tape_payload(tape[_tape_payload(tape[_word]) - 1]);
+}
+
+// The table of a container in a snapshot
+const uint64_t *JSON::View::_table() const
+{
+    const uint64_t *tape = _document->_tape;
+    return _document->_index + _tape_payload(tape[_tape_payload(tape[_word]) - 1]);
+}
+
+bool JSON::View::is_array() const
+{
+    return _tape_tag(_document->_tape[_word]) == '[';
+}
+
+const char *JSON::View::_string(size_t word, size_t *length) const
+{
+    const char *p = _document->_strings + _tape_payload(_document->_tape[word]);
+    uint64_t n;
+    memcpy(&n, p, sizeof(n));
+    *length = (size_t)n;
+    return p + sizeof(n);
+}
+
+// Walks to an array element, resuming from the last one looked up so that
+// visiting the elements in order stays linear
+size_t JSON::View::_element(size_t index) const
+{
+    const uint64_t *tape = _document->_tape;
+
+    if (_document->_index != NULL && _table()[1] != 0)
+    {
+        return _word + (size_t)((_table()[2 + index / 2] >> (32 * (index & 1))) & 0xFFFFFFFF);
+    }
+
+    if (index < _cursor_index)
+    {
+        _cursor = _word + 1;
+        _cursor_index = 0;
+    }
+
+    for (; _cursor_index < index; _cursor_index++)
+    {
+        _cursor = _tape_next(tape, _cursor);
+    }
+
+    return _cursor;
+}
+
+size_t JSON::View::_get(const char *key, JSON::Type expected_type) const
+{
+    if (key == NULL)
+    {
+        throw InvalidKeyException(key);
+    }
+
+    return _get(key, strlen(key), expected_type);
+}
+
+size_t JSON::View::_get(const JSON::Key &key, JSON::Type expected_type) const
+{
+    return _get(key.data(), key.size(), key.hash(), expected_type);
+}
+
+size_t JSON::View::_get(const char *key, size_t length, JSON::Type expected_type) const
+{
+    // Only the tables of a snapshot are looked up by hash
+    size_t hash = _document->_index != NULL ? _string_hash(key, length) : 0;
+    return _get(key, length, hash, expected_type);
+}
+
+size_t JSON::View::_get(const char *key, size_t length, size_t hash, JSON::Type expected_type) const
+{
+    const uint64_t *tape = _document->_tape;
+    size_t value = (size_t)-1;
+
+    if (is_array())
+    {
+        size_t index;
+        if (_parse_index(key, length, &index) && index < size())
+        {
+            value = _element(index);
+        }
+    }
+    else if (_document->_index != NULL && _table()[1] != 0)
+    {
+        const uint64_t *table = _table();
+        size_t mask = (size_t)table[1] - 1;
+
+        for (size_t slot = hash & mask; table[2 + slot] != 0; slot = (slot + 1) & mask)
+        {
+            uint64_t entry = table[2 + slot];
+            if ((entry >> 32) != ((uint64_t)hash >> 32))
+            {
+                continue;
+            }
+
+            size_t i = _word + (size_t)(entry & 0xFFFFFFFF);
+            size_t key_length;
+            const char *data = _string(i, &key_length);
+            if (key_length == length && memcmp(data, key, length) == 0)
+            {
+                value = i + 1;
+                break;
+            }
+        }
+    }
+    else
+    {
+        // Members are compared lengths first, starting after the previous
+        // match and wrapping around, so in-order lookups hit immediately
+        size_t end = (size_t)_tape_payload(tape[_word]) - 1;
+        size_t i = _cursor;
+
+        for (size_t n = size(); n != 0; n--, i = _tape_next(tape, i + 1))
+        {
+            if (i == end)
+            {
+                i = _word + 1;
+            }
+
+            size_t key_length;
+            const char *data = _string(i, &key_length);
+            if (key_length == length && memcmp(data, key, length) == 0)
+            {
+                value = i + 1;
+                _cursor = _tape_next(tape, value);
+                break;
+            }
+        }
+    }
+
+    if (value == (size_t)-1)
+    {
+        throw InvalidKeyException(std::string(key, length).c_str());
+    }
+
+    JSON::Type type = _tape_type(tape[value]);
+    if (type != expected_type && expected_type != JSON::JSON_NULL)
+    {
+        std::string name(key, length);
+        throw WrongTypeException(name, expected_type, type);
+    }
+
+    return value;
+}
+
+size_t JSON::View::_get_by_index(int index, JSON::Type expected_type) const
+{
+    if (!is_array())
+    {
+        return _get(std::to_string(index).c_str(), expected_type);
+    }
+
+    if (index < 0 || (size_t)index >= size())
+    {
+        throw InvalidIndexException(index);
+    }
+
+    const uint64_t *tape = _document->_tape;
+    size_t value = _element((size_t)index);
+
+    JSON::Type type = _tape_type(tape[value]);
+    if (expected_type && type != expected_type)
+    {
+        std::string s = std::to_string(index);
+        throw WrongTypeException(s, expected_type, type);
+    }
+
+    return value;
+}
+
+JSON::View JSON::View::get_object(const char *key) const
+{
+    return JSON::View(_document, _get(key, JSON::OBJECT));
+}
+
+std::string JSON::View::get_string(const char *key) const
+{
+    size_t length;
+    const char *data = _string(_get(key, JSON::STRING), &length);
+    return std::string(data, length);
+}
+
+const char *JSON::View::get_cstring(const char *key) const
+{
+    size_t length;
+    return _string(_get(key, JSON::STRING), &length);
+}
+
+JSON::StringView JSON::View::get_string_view(const char *key) const
+{
+    size_t length;
+    const char *data = _string(_get(key, JSON::STRING), &length);
+    return JSON::StringView(data, length);
+}
+
+double JSON::View::get_number(const char *key) const
+{
+    return _tape_number(_document->_tape, _get(key, JSON::NUMBER));
+}
+
+bool JSON::View::get_boolean(const char *key) const
+{
+    return _tape_tag(_document->_tape[_get(key, JSON::BOOLEAN)]) == 't';
+}
+
+JSON::Type JSON::View::get_type(const char *key) const
+{
+    return _tape_type(_document->_tape[_get(key, JSON::JSON_NULL)]);
+}
+
+JSON::View JSON::View::get_object(std::string &key) const
+{
+    return get_object(key.c_str());
+}
+
+std::string JSON::View::get_string(std::string &key) const
+{
+    return get_string(key.c_str());
+}
+
+const char *JSON::View::get_cstring(std::string &key) const
+{
+    return get_cstring(key.c_str());
+}
+
+JSON::StringView JSON::View::get_string_view(std::string &key) const
+{
+    return get_string_view(key.c_str());
+}
+
+double JSON::View::get_number(std::string &key) const
+{
+    return get_number(key.c_str());
+}
+
+bool JSON::View::get_boolean(std::string &key) const
+{
+    return get_boolean(key.c_str());
+}
+
+JSON::Type JSON::View::get_type(std::string &key) const
+{
+    return get_type(key.c_str());
+}
+
+JSON::View JSON::View::get_object(const JSON::Key &key) const
+{
+    return JSON::View(_document, _get(key, JSON::OBJECT));
+}
+
+std::string JSON::View::get_string(const JSON::Key &key) const
+{
+    size_t length;
+    const char *data = _string(_get(key, JSON::STRING), &length);
+    return std::string(data, length);
+}
+
+const char *JSON::View::get_cstring(const JSON::Key &key) const
+{
+    size_t length;
+    return _string(_get(key, JSON::STRING), &length);
+}
+
+JSON::StringView JSON::View::get_string_view(const JSON::Key &key) const
+{
+    size_t length;
+    const char *data = _string(_get(key, JSON::STRING), &length);
+    return JSON::StringView(data, length);
+}
+
+double JSON::View::get_number(const JSON::Key &key) const
+{
+    return _tape_number(_document->_tape, _get(key, JSON::NUMBER));
+}
+
+bool JSON::View::get_boolean(const JSON::Key &key) const
+{
+    return _tape_tag(_document->_tape[_get(key, JSON::BOOLEAN)]) == 't';
+}
+
+JSON::Type JSON::View::get_type(const JSON::Key &key) const
+{
+    return _tape_type(_document->_tape[_get(key, JSON::JSON_NULL)]);
+}
+
+JSON::View JSON::View::get_object(int index) const
+{
+    return JSON::View(_document, _get_by_index(index, JSON::OBJECT));
+}
+
+std::string JSON::View::get_string(int index) const
+{
+    size_t length;
+    const char *data = _string(_get_by_index(index, JSON::STRING), &length);
+    return std::string(data, length);
+}
+
+const char *JSON::View::get_cstring(int index) const
+{
+    size_t length;
+    return _string(_get_by_index(index, JSON::STRING), &length);
+}
+
+JSON::StringView JSON::View::get_string_view(int index) const
+{
+    size_t length;
+    const char *data = _string(_get_by_index(index, JSON::STRING), &length);
+    return JSON::StringView(data, length);
+}
+
+double JSON::View::get_number(int index) const
+{
+    return _tape_number(_document->_tape, _get_by_index(index, JSON::NUMBER));
+}
+
+bool JSON::View::get_boolean(int index) const
+{
+    return _tape_tag(_document->_tape[_get_by_index(index, JSON::BOOLEAN)]) == 't';
+}
+
+JSON::Type JSON::View::get_type(int index) const
+{
+    return _tape_type(_document->_tape[_get_by_index(index, JSON::JSON_NULL)]);
+}
+
+bool JSON::View::is_object(const char *key) const
+{
+    return get_type(key) == JSON::OBJECT;
+}
+
+bool JSON::View::is_string(const char *key) const
+{
+    return get_type(key) == JSON::STRING;
+}
+
+bool JSON::View::is_number(const char *key) const
+{
+    return get_type(key) == JSON::NUMBER;
+}
+
+bool JSON::View::is_boolean(const char *key) const
+{
+    return get_type(key) == JSON::BOOLEAN;
+}
+
+bool JSON::View::is_null(const char *key) const
+{
+    return get_type(key) == JSON::JSON_NULL;
+}
+
+bool JSON::View::is_object(std::string &key) const
+{
+    return get_type(key) == JSON::OBJECT;
+}
+
+bool JSON::View::is_string(std::string &key) const
+{
+    return get_type(key) == JSON::STRING;
+}
+
+bool JSON::View::is_number(std::string &key) const
+{
+    return get_type(key) == JSON::NUMBER;
+}
+
+bool JSON::View::is_boolean(std::string &key) const
+{
+    return get_type(key) == JSON::BOOLEAN;
+}
+
+bool JSON::View::is_null(std::string &key) const
+{
+    return get_type(key) == JSON::JSON_NULL;
+}
+
+bool JSON::View::is_object(const JSON::Key &key) const
+{
+    return get_type(key) == JSON::OBJECT;
+}
+
+bool JSON::View::is_string(const JSON::Key &key) const
+{
+    return get_type(key) == JSON::STRING;
+}
+
+bool JSON::View::is_number(const JSON::Key &key) const
+{
+    return get_type(key) == JSON::NUMBER;
+}
+
+bool JSON::View::is_boolean(const JSON::Key &key) const
+{
+    return get_type(key) == JSON::BOOLEAN;
+}
+
+bool JSON::View::is_null(const JSON::Key &key) const
+{
+    return get_type(key) == JSON::JSON_NULL;
+}
+
+bool JSON::View::is_object(int index) const
+{
+    return get_type(index) == JSON::OBJECT;
+}
+
+bool JSON::View::is_string(int index) const
+{
+    return get_type(index) == JSON::STRING;
+}
+
+bool JSON::View::is_number(int index) const
+{
+    return get_type(index) == JSON::NUMBER;
+}
+
+bool JSON::View::is_boolean(int index) const
+{
+    return get_type(index) == JSON::BOOLEAN;
+}
+
+bool JSON::View::is_null(int index) const
+{
+    return get_type(index) == JSON::JSON_NULL;
+}
+
+std::string JSON::View::to_string() const
+{
+    return to_string(0);
+}
+
+std::string JSON::View::to_string(unsigned int indent) const
+{
+    std::string repr;
+    write(repr, indent);
+    return repr;
+}
+
+void JSON::View::write(std::string &out, unsigned int indent) const
+{
+    JSON::_Writer writer(&out, indent);
+    writer._reserve(_estimate(indent, 0));
+    _write(&writer, 0);
+}
+
+void JSON::View::write(std::ostream &out, unsigned int indent) const
+{
+    write(_ostream_sink, &out, indent);
+}
+
+void JSON::View::write(JSON::Sink sink, void *context, unsigned int indent) const
+{
+    JSON::_Writer writer(sink, context, indent);
+    _write(&writer, 0);
+}
+
+size_t JSON::View::estimate_size(unsigned int indent) const
+{
+    return _estimate(indent, 0);
+}
+
+size_t JSON::View::_estimate(unsigned int indent, unsigned int depth) const
+{
+    const uint64_t *tape = _document->_tape;
+    size_t end = (size_t)_tape_payload(tape[_word]) - 1;
+    size_t size = 2 + (indent == 0 ? 0 : 2 + indent * depth);
+    size_t length;
+
+    for (size_t i = _word + 1; i < end; i = _tape_next(tape, i))
+    {
+        size += 2 + (indent == 0 ? 0 : 2 + indent * (depth + 1));
+
+        if (!is_array())
+        {
+            _string(i++, &length);
+            size += length + 4;
+        }
+
+        switch (_tape_tag(tape[i]))
+        {
+        case '{':
+        case '[':
+            size += JSON::View(_document, i)._estimate(indent, depth + 1);
+            break;
+        case '"':
+            _string(i, &length);
+            size += length + 2;
+            break;
+        case 'd':
+            size += 12;
+            break;
+        default:
+            size += 5;
+            break;
+        }
+    }
+
+    return size;
+}
+
+void JSON::View::_write(JSON::_Writer *writer, unsigned int depth) const
+{
+    std::string *out = writer->_out;
+    const uint64_t *tape = _document->_tape;
+    size_t end = (size_t)_tape_payload(tape[_word]) - 1;
+    bool array = is_array();
+
+    if (end == _word + 1)
+    {
+        out->append(array ? "[]" : "{}", 2);
+        return;
+    }
+
+    *out += array ? '[' : '{';
+
+    for (size_t i = _word + 1; i < end; i = _tape_next(tape, i))
+    {
+        const char *data;
+        size_t length;
+
+        if (i != _word + 1)
+        {
+            out->append(", ", 2);
+        }
+
+        writer->_newline(depth + 1);
+
+        if (!array)
+        {
+            data = _string(i++, &length);
+            _dump_string(data, length, out);
+            out->append(": ", 2);
+        }
+
+        switch (_tape_tag(tape[i]))
+        {
+        case 'n':
+            out->append("null", 4);
+            break;
+        case '{':
+        case '[':
+            JSON::View(_document, i)._write(writer, depth + 1);
+            break;
+        case '"':
+            data = _string(i, &length);
+            _dump_string(data, length, out);
+            break;
+        case 'd':
+        {
+            char buf[32];
+            out->append(buf, _format_number(_tape_number(tape, i), buf) - buf);
+            break;
+        }
+        case 't':
+            out->append("true", 4);
+            break;
+        case 'f':
+            out->append("false", 5);
+            break;
+        default:
+            throw JSON::UnknownInternalException();
+        }
+
+        writer->_flush();
+    }
+
+    writer->_newline(depth);
+    *out += array ? ']' : '}';
+}
+
+JSON::View::Iterator JSON::View::begin() const
+{
+    return JSON::View::Iterator(this, _word + 1, 0);
+}
+
+JSON::View::Iterator JSON::View::end() const
+{
+    return JSON::View::Iterator(this, (size_t)_tape_payload(_document->_tape[_word]) - 1, size());
+}
+
+JSON::View::Iterator::Iterator(const JSON::View *view, size_t word, size_t index)
+{
+    _view = view;
+    _word = word;
+    _index = index;
+}
+
+JSON::View::Iterator &JSON::View::Iterator::operator++()
+{
+    const uint64_t *tape = _view->_document->_tape;
+    _word = _tape_next(tape, _view->is_array() ? _word : _word + 1);
+    _index++;
+    return *this;
+}
+
+JSON::View::Iterator JSON::View::Iterator::operator++(int)
+{
+    JSON::View::Iterator prev = JSON::View::Iterator(_view, _word, _index);
+    ++(*this);
+    return prev;
+}
+
+bool JSON::View::Iterator::operator==(const JSON::View::Iterator &other)
+{
+    return _word == other._word;
+}
+
+bool JSON::View::Iterator::operator!=(const JSON::View::Iterator &other)
+{
+    return !(*this == other);
+}
+
+std::string &JSON::View::Iterator::operator*()
+{
+    if (!_view->is_array())
+    {
+        size_t length;
+        const char *data = _view->_string(_word, &length);
+        _buffer.assign(data, length);
+        return _buffer;
+    }
+
+    _format_index(_index, &_buffer);
+    return _buffer;
+}
+
+/*
+ * PushParser
+ *
+ * Builds a document from chunks by running the grammar of
+ * Object::_initialize as an explicit state machine, with one frame per
+ * open container. Punctuation is handled a byte at a time. Strings,
+ * numbers and literals are parsed as soon as their end is in sight, and
+ * one that is cut off by the end of a chunk is carried over in _pending.
+ */
+bool _is_scalar(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '+' || c == '.';
+}
+
+JSON::PushParser::PushParser(JSON::ParseMode mode)
+{
+    // Chunks do not outlive the call, so nothing can be borrowed or deferred
+    _mode = (JSON::ParseMode)(mode & (JSON::PARSE_ARENA | JSON::PARSE_INTERN_KEYS));
+    _context = NULL;
+    _start();
+}
+
+JSON::PushParser::~PushParser()
+{
+    _clear();
+}
+
+void JSON::PushParser::_start()
+{
+    JSON::_Arena *arena = NULL;
+    if (_mode & JSON::PARSE_ARENA)
+    {
+        arena = new JSON::_Arena(65536);
+    }
+
+    _context = new JSON::_Context(arena, _mode, _no_end);
+
+    // Each document gets a pool of its own. The context holds a reference
+    // to it until the document is taken, and the arena another.
+    if (_mode & JSON::PARSE_INTERN_KEYS)
+    {
+        _context->_pool = new JSON::_KeyPool();
+        if (arena != NULL)
+        {
+            _context->_pool->_retain();
+            arena->_pool = _context->_pool;
+        }
+    }
+
+    _frames.clear();
+    _pending.clear();
+    _escaped = false;
+    _state = _VALUE;
+}
+
+void JSON::PushParser::_clear()
+{
+    if (_context == NULL)
+    {
+        return;
+    }
+
+    if (_context->_arena == NULL)
+    {
+        for (size_t i = 0; i < _context->_nodes.size(); i++)
+        {
+            _free_node(_context->_nodes[i]);
+        }
+
+        for (size_t i = 0; i < _context->_keys.size(); i++)
+        {
+            _free_string(_context->_keys[i]);
+        }
+    }
+
+    delete _context->_arena;
+
+    if (_context->_pool != NULL)
+    {
+        _context->_pool->_release();
+    }
+
+    delete _context;
+    _context = NULL;
+}
+
+void JSON::PushParser::reset()
+{
+    _clear();
+    _start();
+}
+
+bool JSON::PushParser::done()
+{
+    return _state == _DONE;
+}
+
+void JSON::PushParser::_open(bool is_array)
+{
+    JSON::_Frame frame;
+    frame._node = (size_t)-1;
+    frame._is_array = is_array;
+
+    // The root is assembled by take(), nested containers own a node
+    if (!_frames.empty())
+    {
+        JSON::_Node node;
+        node._type = JSON::OBJECT;
+        node._object = _context->_new_object();
+        _context->_push(_context->_nodes, node);
+        frame._node = _context->_nodes.size() - 1;
+    }
+
+    frame._base = _context->_nodes.size();
+    frame._key_base = _context->_keys.size();
+    _frames.push_back(frame);
+    _state = is_array ? _VALUE_OR_CLOSE : _KEY_OR_CLOSE;
+}
+
+void JSON::PushParser::_close()
+{
+    JSON::_Frame &frame = _frames.back();
+
+    if (frame._node == (size_t)-1)
+    {
+        _state = _DONE;
+        return;
+    }
+
+    JSON::Object *child = _context->_nodes[frame._node]._object;
+    child->_is_array = frame._is_array;
+    child->_arena = _context->_arena;
+    child->_assemble(_context, frame._base, frame._key_base);
+
+    _frames.pop_back();
+    _state = _COMMA_OR_CLOSE;
+}
+
+// Returns the end of the string or scalar token of the given kind that
+// continues at s, or NULL if it runs past the end of the chunk
+const char *JSON::PushParser::_scan(char kind, const char *s, const char *end)
+{
+    if (kind != '"')
+    {
+        while (s < end && _is_scalar(*s))
+        {
+            s++;
+        }
+
+        return s < end ? s : NULL;
+    }
+
+    if (_escaped)
+    {
+        if (s == end)
+        {
+            return NULL;
+        }
+
+        _escaped = false;
+        s++;
+    }
+
+    while (true)
+    {
+        s = _kernels().scan_string(s, end);
+        if (s == end)
+        {
+            return NULL;
+        }
+
+        if (*s != '\\')
+        {
+            // The closing quote, or a control byte the string parser rejects
+            return s + 1;
+        }
+
+        if (s + 1 == end)
+        {
+            _escaped = true;
+            return NULL;
+        }
+
+        s += 2;
+    }
+}
+
+// Parses a complete key or value token spanning [s, end)
+void JSON::PushParser::_token(const char *s, const char *end)
+{
+    JSON::_Context *ctx = _context;
+    ctx->_end = end;
+
+    if (_state == _KEY || _state == _KEY_OR_CLOSE)
+    {
+        s = ctx->_consume_key(s);
+        _state = _COLON;
+    }
+    else
+    {
+        JSON::_Node null_node;
+        null_node._type = JSON::JSON_NULL;
+        ctx->_push(ctx->_nodes, null_node);
+        JSON::_Node *node = &ctx->_nodes.back();
+
+        switch (_peek(s, end))
+        {
+        case 't':
+            s = _CONSUME_TRUE(s, end, ctx->_line);
+            node->_type = JSON::BOOLEAN;
+            node->_boolean = true;
+            break;
+        case 'f':
+            s = _CONSUME_FALSE(s, end, ctx->_line);
+            node->_type = JSON::BOOLEAN;
+            node->_boolean = false;
+            break;
+        case 'n':
+            s = _CONSUME_NULL(s, end, ctx->_line);
+            break;
+        case '"':
+            s = ctx->_consume_string(s, &node->_string);
+            node->_type = JSON::STRING;
+            break;
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '-':
+            s = _consume_number(s, end, &node->_number, ctx->_line);
+            node->_type = JSON::NUMBER;
+            break;
+        default:
+            throw JSON::DecodeException(ctx->_line);
+        }
+
+        _state = _COMMA_OR_CLOSE;
+    }
+
+    // Catches tokens such as "1-2" or "nullx" that only parse partially
+    if (s != end)
+    {
+        throw JSON::DecodeException(ctx->_line);
+    }
+}
+
+// Consumes bytes until the document is complete and returns how many were
+// used, so that whatever follows can be fed again after take()
+size_t JSON::PushParser::feed(const char *data, size_t length)
+{
+    const char *s = data;
+    const char *end = data + length;
+
+    try
+    {
+        // Finish a token that was cut off at the end of the last chunk
+        if (!_pending.empty())
+        {
+            const char *next = _scan(_pending[0], s, end);
+            if (next == NULL)
+            {
+                _pending.append(s, length);
+                return length;
+            }
+
+            _pending.append(s, next - s);
+            _token(_pending.data(), _pending.data() + _pending.length());
+            _pending.clear();
+            s = next;
+        }
+
+        while (_state != _DONE)
+        {
+            s = _consume_whitespace(s, end, &_context->_line);
+            if (s == end)
+            {
+                break;
+            }
+
+            char c = *s;
+            if ((c == '}' || c == ']') && (_state == _VALUE_OR_CLOSE || _state == _KEY_OR_CLOSE || _state == _COMMA_OR_CLOSE))
+            {
+                if (c != (_frames.back()._is_array ? ']' : '}'))
+                {
+                    throw JSON::DecodeException(_context->_line);
+                }
+
+                _close();
+                s++;
+            }
+            else if (c == ',' && _state == _COMMA_OR_CLOSE)
+            {
+                _state = _frames.back()._is_array ? _VALUE : _KEY;
+                s++;
+            }
+            else if (c == ':' && _state == _COLON)
+            {
+                _state = _VALUE;
+                s++;
+            }
+            else if ((c == '{' || c == '[') && (_state == _VALUE || _state == _VALUE_OR_CLOSE))
+            {
+                _open(c == '[');
+                s++;
+            }
+            else if (!_frames.empty() && (_state == _VALUE || _state == _VALUE_OR_CLOSE || (c == '"' && (_state == _KEY || _state == _KEY_OR_CLOSE))))
+            {
+                _escaped = false;
+                const char *next = _scan(c, c == '"' ? s + 1 : s, end);
+                if (next == NULL)
+                {
+                    _pending.assign(s, end - s);
+                    return length;
+                }
+
+                _token(s, next);
+                s = next;
+            }
+            else
+            {
+                throw JSON::DecodeException(_context->_line);
+            }
+        }
+    }
+    catch (...)
+    {
+        reset();
+        throw;
+    }
+
+    return s - data;
+}
+
+size_t JSON::PushParser::feed(std::string &data)
+{
+    return feed(data.data(), data.length());
+}
+
+// Hands over the finished document and starts on the next one
+JSON::Object JSON::PushParser::take()
+{
+    if (_state != _DONE)
+    {
+        throw JSON::DecodeException(_context->_line);
+    }
+
+    JSON::Object object;
+    object._is_array = _frames[0]._is_array;
+    object._arena = _context->_arena;
+    object._owns_arena = object._arena != NULL;
+    object._assemble(_context, 0, 0);
+
+    object._pool = _context->_pool;
+    if (object._pool != NULL && object._arena == NULL)
+    {
+        object._pool->_retain();
+    }
+
+    _context->_arena = NULL;
+    reset();
+    return object;
+}
+
+/*
+ * Handler
+ */
+JSON::Handler::~Handler()
+{
+}
+
+void JSON::Handler::start_object()
+{
+}
+
+void JSON::Handler::key(JSON::StringView)
+{
+}
+
+void JSON::Handler::end_object()
+{
+}
+
+void JSON::Handler::start_array()
+{
+}
+
+void JSON::Handler::end_array()
+{
+}
+
+void JSON::Handler::string(JSON::StringView)
+{
+}
+
+void JSON::Handler::number(double)
+{
+}
+
+void JSON::Handler::boolean(bool)
+{
+}
+
+void JSON::Handler::null()
+{
+}
+
+/*
+ * _Reader
+ *
+ * Walks the same grammar as Object::_initialize, but reports each value
+ * to a Handler instead of storing it. Strings without escapes are passed
+ * as views into the input and the others are decoded into one reused
+ * buffer, so nothing is allocated per value.
+ */
+class JSON::_Reader
+{
+public:
+    const char *_end;
+    int _line;
+    std::string _buffer;
+    JSON::Handler *_handler;
+
+    _Reader(const char *, JSON::Handler *);
+    const char *_string(const char *, JSON::StringView *);
+    const char *_container(const char *);
+    void _parse(const char *);
+};
+
+JSON::_Reader::_Reader(const char *end, JSON::Handler *handler)
+{
+    _end = end;
+    _line = 1;
+    _handler = handler;
+}
+
+const char *JSON::_Reader::_string(const char *s, JSON::StringView *value)
+{
+    const char *run = _kernels().scan_string(s + 1, _end);
+    if (_peek(run, _end) == '"')
+    {
+        *value = JSON::StringView(s + 1, run - s - 1);
+        return run + 1;
+    }
 
-                // Parse key
-                if (_is_array)
-                {
-                    node->_key = new std::string(std::to_string(nodes.size() - 1));
-                }
-                else
-                {
-                    if (*s != '"')
-                    {
-                        throw JSON::DecodeException(line);
-                    }
+    s = _consume_string(s, _end, &_buffer, _line);
+    *value = JSON::StringView(_buffer.data(), _buffer.length());
+    return s;
+}
 
-                    s = _consume_string(s, &node->_key, line);
-                    s = _consume_whitespace(s, &line);
-                    if (*s != ':')
-                    {
-                        throw JSON::DecodeException(line);
-                    }
-                    else
-                    {
-                        s = _consume_whitespace(s + 1, &line);
-                    }
-                }
+const char *JSON::_Reader::_container(const char *s)
+{
+    bool is_array = *s == '[';
+    JSON::StringView text;
 
-                // Parse value
-                switch (*s)
-                {
-                case 't':
-                    s = _CONSUME_TRUE(s, line);
-                    node->_type = JSON::BOOLEAN;
-                    node->_boolean = true;
-                    break;
-                case 'f':
-                    s = _CONSUME_FALSE(s, line);
-                    node->_type = JSON::BOOLEAN;
-                    node->_boolean = false;
-                    break;
-                case 'n':
-                    s = _CONSUME_NULL(s, line);
-                    node->_type = JSON::JSON_NULL;
-                    break;
-                case '"':
-                    s = _consume_string(s, &node->_string, line);
-                    node->_type = JSON::STRING;
-                    break;
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                    s = _consume_number(s, &node->_number, line);
-                    node->_type = JSON::NUMBER;
-                    break;
-                case '{':
-                case '[':
-                    node->_type = JSON::OBJECT;
-                    node->_object = new Object(s, &s);
-                    break;
-                default:
-                    throw JSON::DecodeException(line);
-                }
+    if (is_array)
+    {
+        _handler->start_array();
+    }
+    else
+    {
+        _handler->start_object();
+    }
+
+    s = _consume_whitespace(s + 1, _end, &_line);
+    if (_peek(s, _end) != (is_array ? ']' : '}'))
+    {
+        while (true)
+        {
+            s = _consume_whitespace(s, _end, &_line);
 
-                s = _consume_whitespace(s, &line);
-                if (*s == (_is_array ? ']' : '}'))
+            // Parse key
+            if (!is_array)
+            {
+                if (_peek(s, _end) != '"')
                 {
-                    s++;
-                    break;
+                    throw JSON::DecodeException(_line);
                 }
-                else if (*s == ',')
+
+                s = _string(s, &text);
+                _handler->key(text);
+                s = _consume_whitespace(s, _end, &_line);
+                if (_peek(s, _end) != ':')
                 {
-                    s++;
+                    throw JSON::DecodeException(_line);
                 }
                 else
                 {
-                    throw JSON::DecodeException(line);
+                    s = _consume_whitespace(s + 1, _end, &_line);
                 }
             }
+
+            // Parse value
+            switch (_peek(s, _end))
+            {
+            case 't':
+                s = _CONSUME_TRUE(s, _end, _line);
+                _handler->boolean(true);
+                break;
+            case 'f':
+                s = _CONSUME_FALSE(s, _end, _line);
+                _handler->boolean(false);
+                break;
+            case 'n':
+                s = _CONSUME_NULL(s, _end, _line);
+                _handler->null();
+                break;
+            case '"':
+                s = _string(s, &text);
+                _handler->string(text);
+                break;
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            case '-':
+            {
+                double x;
+                s = _consume_number(s, _end, &x, _line);
+                _handler->number(x);
+                break;
+            }
+            case '{':
+            case '[':
+                s = _container(s);
+                break;
+            default:
+                throw JSON::DecodeException(_line);
+            }
+
+            s = _consume_whitespace(s, _end, &_line);
+            if (_peek(s, _end) == (is_array ? ']' : '}'))
+            {
+                s++;
+                break;
+            }
+            else if (_peek(s, _end) == ',')
+            {
+                s++;
+            }
+            else
+            {
+                throw JSON::DecodeException(_line);
+            }
         }
     }
-    catch (JSON::DecodeException &ex)
+    else
     {
-        for (auto &node : nodes)
-        {
-            delete node;
-        }
+        s++;
+    }
 
-        throw ex;
+    if (is_array)
+    {
+        _handler->end_array();
+    }
+    else
+    {
+        _handler->end_object();
     }
 
+    return s;
+}
 
-    _size = nodes.size();
-    _map = new JSON::_Node *[_size]();
-    _ord = new JSON::_Node *[_size]();
+void JSON::_Reader::_parse(const char *s)
+{
+    if (s == NULL)
+    {
+        throw JSON::DecodeException(0);
+    }
 
-    for (size_t i = 0; i < nodes.size(); i++)
+    s = _consume_whitespace(s, _end, &_line);
+    if (_peek(s, _end) != '{' && _peek(s, _end) != '[')
     {
-        _ord[i] = nodes[i];
+        throw JSON::DecodeException(_line);
+    }
 
-        size_t index = _cstring_hash(nodes[i]->_key->c_str()) % _size;
-        if (_map[index] == NULL)
-        {
-            _map[index] = nodes[i];
-        }
-        else
-        {
-            JSON::_Node *parent;
-            for (parent = _map[index]; parent->_next != NULL; parent = parent->_next)
-                ;
+    s = _container(s);
 
-            parent->_next = nodes[i];
-        }
+    if (_end != _no_end && _consume_whitespace(s, _end, &_line) != _end)
+    {
+        throw JSON::DecodeException(_line);
     }
+}
 
-    return s;
+void JSON::parse(const char *s, JSON::Handler &handler)
+{
+    JSON::_Reader reader(_no_end, &handler);
+    reader._parse(s);
 }
 
-JSON::Object::Object(const JSON::Object &other)
+void JSON::parse(std::string &s, JSON::Handler &handler)
 {
-    _size = other._size;
-    _map = new JSON::_Node *[_size];
-    _ord = new JSON::_Node *[_size];
+    parse(s.c_str(), handler);
+}
 
-    for (size_t i = 0; i < _size; i++)
-    {
-        _ord[i] = new JSON::_Node(*other._ord[i]);
+void JSON::parse(const char *data, size_t length, JSON::Handler &handler)
+{
+    JSON::_Reader reader(data + length, &handler);
+    reader._parse(data);
+}
+
+void JSON::parse_file(const char *path, JSON::Handler &handler)
+{
+    JSON::_Mapping mapping(path);
+    parse(mapping._data, mapping._length, handler);
+}
+
+void JSON::parse_file(std::string &path, JSON::Handler &handler)
+{
+    parse_file(path.c_str(), handler);
+}
 
-        if (other._map[i] == NULL)
+/*
+ * Binding
+ *
+ * The fields of a struct, declared with JSON_BINDING, and a table that finds
+ * them by the hashes their names were given at compile time.
+ */
+template <> const JSON::_Codec JSON::_CodecOf<bool>::codec = {JSON::_BOOLEAN, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<double>::codec = {JSON::_DOUBLE, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<float>::codec = {JSON::_FLOAT, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<int>::codec = {JSON::_INT, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<unsigned int>::codec = {JSON::_UNSIGNED_INT, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<long>::codec = {JSON::_LONG, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<unsigned long>::codec = {JSON::_UNSIGNED_LONG, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<long long>::codec = {JSON::_LONG_LONG, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<unsigned long long>::codec = {JSON::_UNSIGNED_LONG_LONG, NULL, NULL, NULL, NULL};
+template <> const JSON::_Codec JSON::_CodecOf<std::string>::codec = {JSON::_STRING, NULL, NULL, NULL, NULL};
+
+JSON::_Binding::_Binding(const JSON::_Field *fields, size_t size)
+{
+    _fields = fields;
+    _size = size;
+    _table.assign(_table_capacity(size + 1), 0);
+    _mask = _table.size() - 1;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t slot = fields[i]._key.hash() & _mask;
+        while (_table[slot] != 0)
         {
-            _map[i] = NULL;
+            slot = (slot + 1) & _mask;
         }
-        else
-        {
-            _map[i] = new JSON::_Node(*other._map[i]);
 
-            JSON::_Node *parent = _map[i];
-            JSON::_Node *src = other._map[i]->_next;
-            for (; src != NULL; src++)
-            {
-                parent->_next = new JSON::_Node(*src);
-            }
-        }
+        _table[slot] = i + 1;
     }
 }
 
-JSON::Object::~Object()
+const JSON::_Field *JSON::_Binding::_find(const char *key, size_t length, size_t *next) const
 {
-    for (size_t i = 0; i < _size; i++)
+    // Members usually arrive in the order their fields were declared, so
+    // the field after the last one found is tried before hashing the key
+    if (*next < _size)
     {
-        delete _ord[i];
+        const JSON::_Field *field = &_fields[*next];
+        if (field->_key.size() == length && memcmp(field->_key.data(), key, length) == 0)
+        {
+            *next += 1;
+            return field;
+        }
     }
 
-    delete[] _ord;
-    delete[] _map;
-}
+    size_t hash = _string_hash(key, length);
+    for (size_t slot = hash & _mask; _table[slot] != 0; slot = (slot + 1) & _mask)
+    {
+        const JSON::_Field *field = &_fields[_table[slot] - 1];
+        if (field->_key.hash() == hash && field->_key.size() == length && memcmp(field->_key.data(), key, length) == 0)
+        {
+            *next = _table[slot];
+            return field;
+        }
+    }
 
-size_t JSON::Object::size()
-{
-    return _size;
+    return NULL;
 }
 
-bool JSON::Object::is_array()
+/*
+ * _Decoder
+ *
+ * Walks the same grammar as _Reader, but stores each value straight into
+ * the struct member, vector element or string that its Binding selects.
+ * Members without a field are skipped, but still checked against the
+ * grammar, so that decoding accepts the same inputs as parsing.
+ */
+class JSON::_Decoder
 {
-    return _is_array;
+public:
+    const char *_end;
+    int _line;
+    std::string _buffer;
+
+    _Decoder(const char *);
+    const char *_key(const char *, JSON::StringView *);
+    const char *_string(const char *, std::string *);
+    const char *_number(const char *, JSON::_Kind, void *);
+    const char *_value(const char *, const JSON::_Codec *, void *, const char *);
+    const char *_object(const char *, const JSON::_Binding &, void *);
+    const char *_array(const char *, const JSON::_Codec *, void *, const char *);
+    const char *_skip(const char *);
+    const char *_skip_nested(const char *);
+    void _parse(const char *, const JSON::_Codec *, void *);
+};
+
+// The type of the value that starts with c
+JSON::Type _value_type(char c, int line)
+{
+    switch (c)
+    {
+    case '{':
+    case '[':
+        return JSON::OBJECT;
+    case '"':
+        return JSON::STRING;
+    case 't':
+    case 'f':
+        return JSON::BOOLEAN;
+    case 'n':
+        return JSON::JSON_NULL;
+    default:
+        if (c == '-' || _is_digit(c))
+        {
+            return JSON::NUMBER;
+        }
+
+        throw JSON::DecodeException(line);
+    }
 }
 
-JSON::_Node *JSON::Object::_get(const char *key, JSON::Type expected_type)
+// Reads the number in [s, end), which _consume_number has already checked,
+// without rounding it through a double. Returns false unless it is a whole
+// number of at most 64 bits, which may be written with a fraction or an
+// exponent, as in 1.0 or 25e2.
+bool _exact_integer(const char *s, const char *end, bool *negative, uint64_t *magnitude)
 {
-    if (_size == 0 || key == NULL)
+    *negative = *s == '-';
+    if (*negative)
     {
-        throw InvalidKeyException(key);
+        s++;
     }
 
-    size_t index = _cstring_hash(key) % _size;
+    const char *mantissa = s;
+    int64_t digits = 0;
+    int64_t point = -1;
+    for (; s < end && (_is_digit(*s) || *s == '.'); s++)
+    {
+        if (*s == '.')
+        {
+            point = digits;
+        }
+        else
+        {
+            digits++;
+        }
+    }
 
-    for (JSON::_Node *cur = _map[index]; cur; cur = cur->_next)
+    int64_t exponent = 0;
+    if (s < end && (*s == 'e' || *s == 'E'))
     {
-        if (strcmp(key, cur->_key->c_str()) == 0)
+        s++;
+        bool negative_exponent = *s == '-';
+        if (*s == '-' || *s == '+')
         {
-            if (cur->_type == expected_type || expected_type == JSON::JSON_NULL)
+            s++;
+        }
+
+        // Larger exponents cannot give a whole number of 64 bits anyway
+        for (; s < end && _is_digit(*s); s++)
+        {
+            if (exponent < 100000)
             {
-                return cur;
+                exponent = exponent * 10 + (*s - '0');
             }
-            else
+        }
+
+        if (negative_exponent)
+        {
+            exponent = -exponent;
+        }
+    }
+
+    // Digits at positions up to whole come before the decimal point
+    int64_t whole = (point < 0 ? digits : point) + exponent;
+    uint64_t x = 0;
+    int64_t i = 0;
+    for (s = mantissa; i < digits; s++)
+    {
+        if (*s == '.')
+        {
+            continue;
+        }
+
+        unsigned int d = *s - '0';
+        if (i < whole)
+        {
+            if (x > (UINT64_MAX - d) / 10)
             {
-                throw WrongTypeException(key, expected_type, cur->_type);
+                return false;
             }
+
+            x = x * 10 + d;
+        }
+        else if (d != 0)
+        {
+            return false;
         }
+
+        i++;
     }
 
-    throw InvalidKeyException(key);
-}
+    for (; i < whole && x != 0; i++)
+    {
+        if (x > UINT64_MAX / 10)
+        {
+            return false;
+        }
 
-JSON::Object *JSON::Object::get_object(const char *key)
-{
-    return _get(key, JSON::OBJECT)->_object;
-}
+        x *= 10;
+    }
 
-std::string &JSON::Object::get_string(const char *key)
-{
-    return *_get(key, JSON::STRING)->_string;
+    *magnitude = x;
+    return true;
 }
 
-const char *JSON::Object::get_cstring(const char *key)
+// Stores a whole number as a T if its magnitude is at most min when it is
+// negative and at most max otherwise
+template <typename T>
+void _store_integer(void *target, bool negative, uint64_t magnitude, uint64_t min, uint64_t max, int line)
 {
-    return _get(key, JSON::STRING)->_string->c_str();
-}
+    if (magnitude > (negative ? min : max))
+    {
+        throw JSON::DecodeException(line);
+    }
 
-double JSON::Object::get_number(const char *key)
-{
-    return _get(key, JSON::NUMBER)->_number;
+    if (negative && magnitude != 0)
+    {
+        *(T *)target = -(T)(magnitude - 1) - 1;
+    }
+    else
+    {
+        *(T *)target = (T)magnitude;
+    }
 }
 
-bool JSON::Object::get_boolean(const char *key)
+JSON::_Decoder::_Decoder(const char *end)
 {
-    return _get(key, JSON::BOOLEAN)->_boolean;
+    _end = end;
+    _line = 1;
 }
 
-JSON::Type JSON::Object::get_type(const char *key)
+const char *JSON::_Decoder::_key(const char *s, JSON::StringView *key)
 {
-    return _get(key, JSON::JSON_NULL)->_type;
-}
+    const char *run = _kernels().scan_string(s + 1, _end);
+    if (_peek(run, _end) == '"')
+    {
+        *key = JSON::StringView(s + 1, run - s - 1);
+        return run + 1;
+    }
 
-JSON::Object *JSON::Object::get_object(std::string &key)
-{
-    return _get(key.c_str(), JSON::OBJECT)->_object;
+    s = _consume_string(s, _end, &_buffer, _line);
+    *key = JSON::StringView(_buffer.data(), _buffer.length());
+    return s;
 }
 
-std::string &JSON::Object::get_string(std::string &key)
+const char *JSON::_Decoder::_string(const char *s, std::string *value)
 {
-    return *_get(key.c_str(), JSON::STRING)->_string;
-}
+    const char *run = _kernels().scan_string(s + 1, _end);
+    if (_peek(run, _end) == '"')
+    {
+        value->assign(s + 1, run - s - 1);
+        return run + 1;
+    }
 
-const char *JSON::Object::get_cstring(std::string &key)
-{
-    return _get(key.c_str(), JSON::STRING)->_string->c_str();
+    return _consume_string(s, _end, value, _line);
 }
 
-double JSON::Object::get_number(std::string &key)
+// Integer members are read from the digits themselves, since a double
+// cannot hold every 64-bit value
+const char *JSON::_Decoder::_number(const char *s, JSON::_Kind kind, void *target)
 {
-    return _get(key.c_str(), JSON::NUMBER)->_number;
+    const char *start = s;
+    double x;
+    s = _consume_number(s, _end, &x, _line);
+
+    if (kind == JSON::_DOUBLE)
+    {
+        *(double *)target = x;
+        return s;
+    }
+    else if (kind == JSON::_FLOAT)
+    {
+        *(float *)target = (float)x;
+        return s;
+    }
+
+    bool negative;
+    uint64_t magnitude;
+    if (!_exact_integer(start, s, &negative, &magnitude))
+    {
+        throw JSON::DecodeException(_line);
+    }
+
+    switch (kind)
+    {
+    case JSON::_INT:
+        _store_integer<int>(target, negative, magnitude, (uint64_t)INT_MAX + 1, INT_MAX, _line);
+        break;
+    case JSON::_UNSIGNED_INT:
+        _store_integer<unsigned int>(target, negative, magnitude, 0, UINT_MAX, _line);
+        break;
+    case JSON::_LONG:
+        _store_integer<long>(target, negative, magnitude, (uint64_t)LONG_MAX + 1, LONG_MAX, _line);
+        break;
+    case JSON::_UNSIGNED_LONG:
+        _store_integer<unsigned long>(target, negative, magnitude, 0, ULONG_MAX, _line);
+        break;
+    case JSON::_LONG_LONG:
+        _store_integer<long long>(target, negative, magnitude, (uint64_t)LLONG_MAX + 1, LLONG_MAX, _line);
+        break;
+    case JSON::_UNSIGNED_LONG_LONG:
+        _store_integer<unsigned long long>(target, negative, magnitude, 0, ULLONG_MAX, _line);
+        break;
+    default:
+        throw JSON::UnknownInternalException();
+    }
+
+    return s;
 }
 
-bool JSON::Object::get_boolean(std::string &key)
+const char *JSON::_Decoder::_value(const char *s, const JSON::_Codec *codec, void *target, const char *name)
 {
-    return _get(key.c_str(), JSON::BOOLEAN)->_boolean;
-}
+    char c = _peek(s, _end);
+    JSON::Type expected = JSON::NUMBER;
+
+    // A null leaves the target as it was
+    if (c == 'n')
+    {
+        return _CONSUME_NULL(s, _end, _line);
+    }
+
+    switch (codec->_kind)
+    {
+    case JSON::_BOOLEAN:
+        expected = JSON::BOOLEAN;
+        if (c == 't')
+        {
+            *(bool *)target = true;
+            return _CONSUME_TRUE(s, _end, _line);
+        }
+        else if (c == 'f')
+        {
+            *(bool *)target = false;
+            return _CONSUME_FALSE(s, _end, _line);
+        }
+        break;
+    case JSON::_STRING:
+        expected = JSON::STRING;
+        if (c == '"')
+        {
+            return _string(s, (std::string *)target);
+        }
+        break;
+    case JSON::_STRUCT:
+        expected = JSON::OBJECT;
+        if (c == '{')
+        {
+            return _object(s, codec->_binding(), target);
+        }
+        break;
+    case JSON::_VECTOR:
+        expected = JSON::OBJECT;
+        if (c == '[')
+        {
+            return _array(s, codec, target, name);
+        }
+        break;
+    default:
+        if (c == '-' || _is_digit(c))
+        {
+            return _number(s, codec->_kind, target);
+        }
+        break;
+    }
 
-JSON::Type JSON::Object::get_type(std::string &key)
-{
-    return _get(key.c_str(), JSON::JSON_NULL)->_type;
+    throw JSON::WrongTypeException(name, expected, _value_type(c, _line));
 }
 
-JSON::_Node *JSON::Object::_get_by_index(int index, JSON::Type expected_type)
+const char *JSON::_Decoder::_object(const char *s, const JSON::_Binding &binding, void *target)
 {
-    if (!_is_array)
+    JSON::StringView key;
+    size_t next = 0;
+
+    s = _consume_whitespace(s + 1, _end, &_line);
+    if (_peek(s, _end) == '}')
     {
-        return _get(std::to_string(index).c_str(), JSON::OBJECT);
+        return s + 1;
     }
 
-    if (index < 0 || (size_t)index >= _size)
+    while (true)
     {
-        throw InvalidIndexException(index);
+        s = _consume_whitespace(s, _end, &_line);
+        if (_peek(s, _end) != '"')
+        {
+            throw JSON::DecodeException(_line);
+        }
+
+        s = _key(s, &key);
+        s = _consume_whitespace(s, _end, &_line);
+        if (_peek(s, _end) != ':')
+        {
+            throw JSON::DecodeException(_line);
+        }
+
+        s = _consume_whitespace(s + 1, _end, &_line);
+        const JSON::_Field *field = binding._find(key.data(), key.size(), &next);
+        if (field == NULL)
+        {
+            s = _skip(s);
+        }
+        else
+        {
+            s = _value(s, field->_codec, field->_member(target), field->_key.data());
+        }
+
+        s = _consume_whitespace(s, _end, &_line);
+        if (_peek(s, _end) == '}')
+        {
+            return s + 1;
+        }
+        else if (_peek(s, _end) == ',')
+        {
+            s++;
+        }
+        else
+        {
+            throw JSON::DecodeException(_line);
+        }
     }
+}
+
+const char *JSON::_Decoder::_array(const char *s, const JSON::_Codec *codec, void *target, const char *name)
+{
+    codec->_clear(target);
 
-    if (expected_type && _ord[index]->_type != expected_type)
+    s = _consume_whitespace(s + 1, _end, &_line);
+    if (_peek(s, _end) == ']')
     {
-        std::string s = std::to_string(index);
-        throw WrongTypeException(s, expected_type, _ord[index]->_type);
+        return s + 1;
     }
 
-    return _ord[index];
-}
+    while (true)
+    {
+        s = _consume_whitespace(s, _end, &_line);
+        s = _value(s, codec->_element, codec->_append(target), name);
 
-JSON::Object *JSON::Object::get_object(int index)
-{
-    return _get_by_index(index, JSON::OBJECT)->_object;
+        s = _consume_whitespace(s, _end, &_line);
+        if (_peek(s, _end) == ']')
+        {
+            return s + 1;
+        }
+        else if (_peek(s, _end) == ',')
+        {
+            s++;
+        }
+        else
+        {
+            throw JSON::DecodeException(_line);
+        }
+    }
 }
 
-std::string &JSON::Object::get_string(int index)
+const char *JSON::_Decoder::_skip(const char *s)
 {
-    return *_get_by_index(index, JSON::STRING)->_string;
+    switch (_peek(s, _end))
+    {
+    case 't':
+        return _CONSUME_TRUE(s, _end, _line);
+    case 'f':
+        return _CONSUME_FALSE(s, _end, _line);
+    case 'n':
+        return _CONSUME_NULL(s, _end, _line);
+    case '"':
+        return _consume_string(s, _end, &_buffer, _line);
+    case '{':
+    case '[':
+        return _skip_nested(s);
+    default:
+    {
+        double x;
+        return _consume_number(s, _end, &x, _line);
+    }
+    }
 }
 
-const char *JSON::Object::get_cstring(int index)
+// Checks an object or array that no field asked for, storing nothing
+const char *JSON::_Decoder::_skip_nested(const char *s)
 {
-    return _get_by_index(index, JSON::STRING)->_string->c_str();
-}
+    bool is_array = *s == '[';
+    char close = is_array ? ']' : '}';
 
-double JSON::Object::get_number(int index)
-{
-    return _get_by_index(index, JSON::NUMBER)->_number;
-}
+    s = _consume_whitespace(s + 1, _end, &_line);
+    if (_peek(s, _end) == close)
+    {
+        return s + 1;
+    }
 
-bool JSON::Object::get_boolean(int index)
-{
-    return _get_by_index(index, JSON::BOOLEAN)->_boolean;
-}
+    while (true)
+    {
+        s = _consume_whitespace(s, _end, &_line);
+        if (!is_array)
+        {
+            if (_peek(s, _end) != '"')
+            {
+                throw JSON::DecodeException(_line);
+            }
 
-JSON::Type JSON::Object::get_type(int index)
-{
-    return _get_by_index(index, JSON::JSON_NULL)->_type;
-}
+            s = _consume_string(s, _end, &_buffer, _line);
+            s = _consume_whitespace(s, _end, &_line);
+            if (_peek(s, _end) != ':')
+            {
+                throw JSON::DecodeException(_line);
+            }
 
-bool JSON::Object::is_object(const char *key)
-{
-    return get_type(key) == JSON::OBJECT;
-}
+            s = _consume_whitespace(s + 1, _end, &_line);
+        }
 
-bool JSON::Object::is_string(const char *key)
-{
-    return get_type(key) == JSON::STRING;
-}
+        s = _skip(s);
 
-bool JSON::Object::is_number(const char *key)
-{
-    return get_type(key) == JSON::NUMBER;
+        s = _consume_whitespace(s, _end, &_line);
+        if (_peek(s, _end) == close)
+        {
+            return s + 1;
+        }
+        else if (_peek(s, _end) == ',')
+        {
+            s++;
+        }
+        else
+        {
+            throw JSON::DecodeException(_line);
+        }
+    }
 }
 
-bool JSON::Object::is_boolean(const char *key)
+void JSON::_Decoder::_parse(const char *s, const JSON::_Codec *codec, void *target)
 {
-    return get_type(key) == JSON::BOOLEAN;
-}
+    if (s == NULL)
+    {
+        throw JSON::DecodeException(0);
+    }
 
-bool JSON::Object::is_null(const char *key)
-{
-    return get_type(key) == JSON::JSON_NULL;
-}
+    s = _consume_whitespace(s, _end, &_line);
+    if (_peek(s, _end) != '{' && _peek(s, _end) != '[')
+    {
+        throw JSON::DecodeException(_line);
+    }
 
-bool JSON::Object::is_object(std::string &key)
-{
-    return get_type(key) == JSON::OBJECT;
-}
+    s = _value(s, codec, target, "");
 
-bool JSON::Object::is_string(std::string &key)
-{
-    return get_type(key) == JSON::STRING;
+    if (_end != _no_end && _consume_whitespace(s, _end, &_line) != _end)
+    {
+        throw JSON::DecodeException(_line);
+    }
 }
 
-bool JSON::Object::is_number(std::string &key)
+void JSON::_decode(const char *s, const JSON::_Codec *codec, void *value)
 {
-    return get_type(key) == JSON::NUMBER;
+    JSON::_Decoder decoder(_no_end);
+    decoder._parse(s, codec, value);
 }
 
-bool JSON::Object::is_boolean(std::string &key)
+void JSON::_decode(const char *data, size_t length, const JSON::_Codec *codec, void *value)
 {
-    return get_type(key) == JSON::BOOLEAN;
+    JSON::_Decoder decoder(data + length);
+    decoder._parse(data, codec, value);
 }
 
-bool JSON::Object::is_null(std::string &key)
+void JSON::_decode_file(const char *path, const JSON::_Codec *codec, void *value)
 {
-    return get_type(key) == JSON::JSON_NULL;
+    JSON::_Mapping mapping(path);
+    _decode(mapping._data, mapping._length, codec, value);
 }
 
-std::string JSON::Object::to_string()
+/*
+ * _LineBatch
+ *
+ * Splits newline-delimited input into chunks of about _CHUNK_SIZE bytes
+ * that end on a line break. Each worker parses whole chunks, waits until
+ * the chunk before its own has been delivered and then hands its records
+ * to the sink itself. Records are therefore freed by the thread that
+ * allocated them, sink calls never overlap and arrive in input order, and
+ * at most one chunk per thread is held in memory. The calling thread is
+ * one of the workers.
+ */
+class JSON::_LineBatch
 {
-    return to_string(0, 0);
-}
-
-std::string JSON::Object::to_string(unsigned int indent)
+public:
+    struct _Chunk
+    {
+        const char *_begin;
+        const char *_end;
+    };
+
+    static const size_t _CHUNK_SIZE = 1 << 16;
+
+    JSON::ParseMode _mode;
+    JSON::KeyPool _pool;
+    JSON::RecordSink _sink;
+    void *_context;
+    std::vector<_Chunk> _chunks;
+    size_t _next;
+    size_t _delivered;
+    size_t _index;
+    int _line;
+    bool _abort;
+    std::exception_ptr _error;
+    std::mutex _mutex;
+    std::condition_variable _changed;
+
+    _LineBatch(const char *, size_t, JSON::ParseMode, JSON::RecordSink, void *);
+    void _parse(const _Chunk &, std::vector<JSON::Object *> *, int *);
+    void _work();
+    void _run(unsigned int);
+};
+
+JSON::_LineBatch::_LineBatch(const char *data, size_t length, JSON::ParseMode mode, JSON::RecordSink sink, void *context)
 {
-    return to_string(indent, 0);
+    _mode = mode;
+    _sink = sink;
+    _context = context;
+    _next = 0;
+    _delivered = 0;
+    _index = 0;
+    _line = 0;
+    _abort = false;
+
+    const char *s = data;
+    const char *end = data + length;
+    while (s < end)
+    {
+        const char *split = (size_t)(end - s) > _CHUNK_SIZE ? s + _CHUNK_SIZE : end;
+        const char *eol = (const char *)memchr(split, '\n', end - split);
+        split = eol != NULL ? eol + 1 : end;
+
+        _Chunk chunk;
+        chunk._begin = s;
+        chunk._end = split;
+        _chunks.push_back(chunk);
+        s = split;
+    }
 }
 
-std::string JSON::Object::to_string(unsigned int indent, unsigned int depth)
+// Parses every line of the chunk, counting the line breaks passed so far
+void JSON::_LineBatch::_parse(const _Chunk &chunk, std::vector<JSON::Object *> *records, int *lines)
 {
-    std::string tabzero(indent * depth, ' ');
-    std::string tabone(indent * (depth + 1), ' ');
-    std::string linesep = indent == 0 ? "" : "\r\n";
+    const char *s = chunk._begin;
 
-    // Construct string
-    if (_size == 0)
+    while (s < chunk._end)
     {
-        return tabzero + "{}";
+        const char *eol = (const char *)memchr(s, '\n', chunk._end - s);
+        if (eol == NULL)
+        {
+            eol = chunk._end;
+        }
+
+        // Blank lines are skipped, and interned keys are shared by all
+        // records of the batch
+        int line = 0;
+        bool blank = _consume_whitespace(s, eol, &line) == eol;
+        if (!blank && (_mode & JSON::PARSE_INTERN_KEYS))
+        {
+            records->push_back(new JSON::Object(s, eol - s, _pool, _mode));
+        }
+        else if (!blank)
+        {
+            records->push_back(new JSON::Object(s, eol - s, _mode));
+        }
+
+        if (eol == chunk._end)
+        {
+            break;
+        }
+
+        *lines += 1;
+        s = eol + 1;
     }
+}
 
-    std::string repr = tabzero + (_is_array ? '[' : '{');
+void JSON::_LineBatch::_work()
+{
+    std::vector<JSON::Object *> records;
 
-    for (auto iter = begin();;)
+    while (true)
     {
-        repr += linesep;
-        repr += tabone;
+        size_t i;
 
-        if (!_is_array)
         {
-            repr += _dump_string(*iter);
-            repr += ": ";
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_abort || _next == _chunks.size())
+            {
+                return;
+            }
+
+            i = _next++;
         }
 
-        switch (get_type(*iter))
+        int lines = 0;
+        int error_line = 0;
+        std::exception_ptr error;
+
+        try
         {
-        case JSON::JSON_NULL:
-            repr += "null";
-            break;
-        case JSON::OBJECT:
-            repr += &get_object(*iter)->to_string(indent, depth + 1)[indent * (depth + 1)];
-            break;
-        case JSON::STRING:
+            _parse(_chunks[i], &records, &lines);
+        }
+        catch (JSON::DecodeException &)
         {
-            std::string s = get_string(*iter);
-            repr += _dump_string(s);
-            break;
+            error_line = lines + 1;
         }
-        case JSON::NUMBER:
-            repr += std::to_string(get_number(*iter));
-            break;
-        case JSON::BOOLEAN:
-            repr += get_boolean(*iter) ? "true" : "false";
-            break;
-        default:
-            throw JSON::UnknownInternalException();
-            break;
+        catch (...)
+        {
+            error = std::current_exception();
         }
 
-        if (++iter != end())
+        bool deliver;
+
         {
-            repr += ", ";
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_abort && _delivered != i)
+            {
+                _changed.wait(lock);
+            }
+
+            deliver = !_abort;
         }
-        else
+
+        // Until _delivered moves on, this thread alone owns the sink
+        if (deliver)
         {
-            break;
+            try
+            {
+                for (size_t j = 0; j < records.size(); j++)
+                {
+                    _sink(*records[j], _index++, _context);
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            if (!error && error_line != 0)
+            {
+                try
+                {
+                    throw JSON::DecodeException(_line + error_line);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            _line += lines;
         }
-    }
 
-    repr += linesep + tabzero + (_is_array ? ']' : '}');
-    return repr;
+        for (size_t j = 0; j < records.size(); j++)
+        {
+            delete records[j];
+        }
+        records.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (error && !_abort)
+            {
+                _abort = true;
+                _error = error;
+            }
+
+            _delivered = i + 1;
+        }
+        _changed.notify_all();
+    }
 }
 
-JSON::Object::Iterator JSON::Object::begin()
+void JSON::_LineBatch::_run(unsigned int threads)
 {
-    if (_size == 0)
+    std::vector<std::thread> workers;
+
+    try
     {
-        return end();
+        for (unsigned int i = 1; i < threads; i++)
+        {
+            workers.push_back(std::thread(&JSON::_LineBatch::_work, this));
+        }
     }
-    else
+    catch (...)
     {
-        return JSON::Object::Iterator(_ord);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _abort = true;
+        }
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+
+        throw;
     }
-}
 
-JSON::Object::Iterator JSON::Object::end()
-{
-    return JSON::Object::Iterator(_ord + _size);
-}
+    _work();
 
-JSON::Object::Iterator::Iterator(JSON::_Node **p)
-{
-    _p = p;
-}
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
 
-JSON::Object::Iterator &JSON::Object::Iterator::operator++()
-{
-    ++_p;
-    return *this;
+    if (_error)
+    {
+        std::rethrow_exception(_error);
+    }
 }
 
-JSON::Object::Iterator JSON::Object::Iterator::operator++(int)
+void JSON::parse_lines(const char *data, size_t length, JSON::RecordSink sink, void *context, unsigned int threads, JSON::ParseMode mode)
 {
-    JSON::Object::Iterator prev = JSON::Object::Iterator(_p);
-    ++(*this);
-    return prev;
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+
+    JSON::_LineBatch batch(data, length, mode, sink, context);
+    batch._run(threads);
 }
 
-bool JSON::Object::Iterator::operator==(const JSON::Object::Iterator &other)
+void JSON::parse_lines(std::string &data, JSON::RecordSink sink, void *context, unsigned int threads, JSON::ParseMode mode)
 {
-    return _p == other._p;
+    parse_lines(data.data(), data.length(), sink, context, threads, mode);
 }
 
-bool JSON::Object::Iterator::operator!=(const JSON::Object::Iterator &other)
+void JSON::parse_lines_file(const char *path, JSON::RecordSink sink, void *context, unsigned int threads, JSON::ParseMode mode)
 {
-    return !(*this == other);
+    JSON::_Mapping mapping(path);
+    parse_lines(mapping._data, mapping._length, sink, context, threads, mode);
 }
 
-std::string &JSON::Object::Iterator::operator*()
+void JSON::parse_lines_file(std::string &path, JSON::RecordSink sink, void *context, unsigned int threads, JSON::ParseMode mode)
 {
-    return *(*_p)->_key;
+    parse_lines_file(path.c_str(), sink, context, threads, mode);
 }
 
 /*
@@ -994,6 +8939,35 @@ JSON::InvalidControlCharacterException::InvalidControlCharacterException()
     _static_message = "Encountered invalid control character in String.";
 }
 
+JSON::FileException::FileException(const char *path)
+{
+    std::string message;
+    message += "Could not access file \"";
+    message += path ? path : "(NULL)";
+    message += "\".";
+
+    _message = new char[message.length() + 1];
+    strcpy(_message, message.c_str());
+}
+
+JSON::InvalidPathException::InvalidPathException(const char *pointer)
+{
+    std::string message;
+    message += "Attempted to use the malformed JSON Pointer ";
+    message += pointer ? "\"" : "";
+    message += pointer ? pointer : "(NULL)";
+    message += pointer ? "\"" : "";
+    message += ".";
+
+    _message = new char[message.length() + 1];
+    strcpy(_message, message.c_str());
+}
+
+JSON::NotAnArrayException::NotAnArrayException()
+{
+    _static_message = "Attempted to append to an Object, but only Arrays can be appended to.";
+}
+
 JSON::UnknownInternalException::UnknownInternalException()
 {
     _static_message = "Encountered an unexpected internal state.";
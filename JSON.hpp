@@ -1,14 +1,36 @@
 #ifndef CPP_JSON_HPP
 #define CPP_JSON_HPP
 
+#include <cstddef>
 #include <exception>
+#include <iosfwd>
+#include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace JSON
 {
     struct _Node;
+    struct _Slot;
+    struct _String;
+    class _Arena;
+    class _KeyPool;
+    class _Context;
+    class _Mapping;
+    class _Writer;
+    class _TapeBuilder;
+    class _Reader;
+    class _LineBatch;
+    class _Decoder;
+    class _Binding;
+    class Key;
+    class KeyPool;
     class Array;
     class Object;
+    class Document;
+    class View;
+    class PushParser;
+    class Path;
 
     enum Type
     {
@@ -19,6 +41,144 @@ namespace JSON
         BOOLEAN
     };
 
+    enum ParseMode
+    {
+        PARSE_DEFAULT = 0,
+        PARSE_ARENA = 1 << 0,
+        PARSE_LAZY = 1 << 1,
+        PARSE_ZERO_COPY = 1 << 2,
+        PARSE_PARALLEL = 1 << 3,
+        PARSE_INTERN_KEYS = 1 << 4
+    };
+
+    enum PathStatus
+    {
+        PATH_OK = 0,
+        PATH_NOT_FOUND,
+        PATH_WRONG_TYPE
+    };
+
+    inline ParseMode operator|(ParseMode a, ParseMode b)
+    {
+        return (ParseMode)((int)a | (int)b);
+    }
+
+    typedef void (*Sink)(const char *data, size_t length, void *context);
+    typedef void (*RecordSink)(JSON::Object &record, size_t index, void *context);
+
+    struct ParseStats
+    {
+        size_t allocations;
+        size_t bytes;
+    };
+
+    class StringView
+    {
+    private:
+        const char *_data;
+        size_t _length;
+
+    public:
+        StringView();
+        StringView(const char *data, size_t length);
+        const char *data() const;
+        size_t size() const;
+        size_t length() const;
+        std::string str() const;
+        bool operator==(const StringView &other) const;
+        bool operator==(const char *other) const;
+        bool operator!=(const StringView &other) const;
+        bool operator!=(const char *other) const;
+    };
+
+    // The hash used by Object's key index, written so that it can be
+    // evaluated at compile time. It must stay in step with _string_hash().
+    constexpr uint64_t _key_word(const char *s, size_t length, size_t i)
+    {
+        return i < length && i < 8 ? (uint64_t)(unsigned char)s[i] << (8 * i) | _key_word(s, length, i + 1) : 0;
+    }
+
+    constexpr uint64_t _key_shift(uint64_t x, unsigned int bits)
+    {
+        return x ^ (x >> bits);
+    }
+
+    constexpr uint64_t _key_hash(const char *s, size_t length, uint64_t x)
+    {
+        return length >= 8
+            ? _key_hash(s + 8, length - 8, _key_shift((x ^ _key_word(s, 8, 0)) * 0x9E3779B97F4A7C15ull, 29))
+            : _key_shift(_key_shift((x ^ _key_word(s, length, 0)) * 0x9E3779B97F4A7C15ull, 32) * 0xD6E8FEB86659FD93ull, 32);
+    }
+
+    class Key
+    {
+    private:
+        const char *_data;
+        size_t _length;
+        size_t _hash;
+
+    public:
+        constexpr Key(const char *data, size_t length)
+            : _data(data), _length(length), _hash((size_t)_key_hash(data, length, 1000003 ^ (uint64_t)length))
+        {
+        }
+
+        template <size_t N>
+        constexpr Key(const char (&s)[N]) : Key(s, N - 1)
+        {
+        }
+
+        constexpr const char *data() const
+        {
+            return _data;
+        }
+
+        constexpr size_t size() const
+        {
+            return _length;
+        }
+
+        constexpr size_t hash() const
+        {
+            return _hash;
+        }
+    };
+
+    namespace literals
+    {
+        constexpr JSON::Key operator"" _k(const char *s, size_t length)
+        {
+            return JSON::Key(s, length);
+        }
+    }
+
+    class KeyPool
+    {
+    public:
+        KeyPool();
+        KeyPool(const KeyPool &);
+        ~KeyPool();
+
+        JSON::KeyPool &operator=(const KeyPool &);
+
+        JSON::Key key(const char *s);
+        JSON::Key key(std::string &s);
+        size_t size() const;
+        size_t bytes() const;
+
+    private:
+        friend class JSON::Object;
+
+        JSON::_KeyPool *_pool;
+    };
+
+    struct _String
+    {
+        const char *_data;
+        size_t _length;
+        std::string *_value;
+    };
+
     struct _Node
     {
     public:
@@ -27,17 +187,33 @@ namespace JSON
         {
             JSON::Object *_object;
             JSON::Array *_array;
-            std::string *_string;
+            JSON::_String _string;
             double _number;
             bool _boolean;
         };
+    };
+
+    struct _Slot
+    {
+        uint32_t _hash;
+        uint32_t _length;
+        JSON::_Node *_node;
+    };
 
-        std::string *_key;
-        _Node *_next;
+    struct _Frame
+    {
+        size_t _node;
+        size_t _base;
+        size_t _key_base;
+        bool _is_array;
+    };
 
-        _Node();
-        _Node(const _Node &);
-        ~_Node();
+    struct _Step
+    {
+        size_t _offset;
+        size_t _length;
+        size_t _hash;
+        size_t _index;
     };
 
     class Object
@@ -46,23 +222,48 @@ namespace JSON
         class Iterator
         {
         private:
-            JSON::_Node **_p;
+            JSON::Object *_object;
+            size_t _index;
+            std::string _buffer;
 
         public:
-            Iterator(JSON::_Node **);
+            Iterator(JSON::Object *, size_t);
             Iterator &operator++();
             Iterator operator++(int);
             bool operator==(const Iterator &other);
             bool operator!=(const Iterator &other);
             std::string &operator*();
+            JSON::StringView key();
         };
 
         Object(const char *s);
         Object(std::string &s);
         Object(const char *, const char **);
+        Object(const char *s, JSON::ParseMode mode, JSON::ParseStats *stats = NULL);
+        Object(std::string &s, JSON::ParseMode mode, JSON::ParseStats *stats = NULL);
+        Object(const char *data, size_t length);
+        Object(const char *data, size_t length, JSON::ParseMode mode, JSON::ParseStats *stats = NULL);
+        Object(const char *s, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        Object(std::string &s, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        Object(const char *data, size_t length, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
         Object(const Object &);
+        Object(Object &&) noexcept;
         ~Object();
 
+        JSON::Object &operator=(const Object &);
+        JSON::Object &operator=(Object &&);
+
+        static JSON::Object from_file(const char *path, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_file(std::string &path, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_file(const char *path, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_file(std::string &path, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_msgpack(const char *data, size_t length, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_msgpack(std::string &data, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_msgpack(const char *data, size_t length, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object from_msgpack(std::string &data, JSON::KeyPool &pool, JSON::ParseMode mode = JSON::PARSE_DEFAULT, JSON::ParseStats *stats = NULL);
+        static JSON::Object object(JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+        static JSON::Object array(JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+
         JSON::Object::Iterator begin();
         JSON::Object::Iterator end();
 
@@ -70,54 +271,543 @@ namespace JSON
         bool is_array();
 
         JSON::Object *get_object(const char *key);
+        JSON::Object *get_object(const JSON::Key &key);
         JSON::Object *get_object(std::string &key);
         JSON::Object *get_object(int index);
         std::string &get_string(const char *key);
+        std::string &get_string(const JSON::Key &key);
         std::string &get_string(std::string &key);
         std::string &get_string(int index);
         const char *get_cstring(const char *key);
+        const char *get_cstring(const JSON::Key &key);
         const char *get_cstring(std::string &key);
         const char *get_cstring(int index);
+        JSON::StringView get_string_view(const char *key);
+        JSON::StringView get_string_view(const JSON::Key &key);
+        JSON::StringView get_string_view(std::string &key);
+        JSON::StringView get_string_view(int index);
         double get_number(const char *key);
+        double get_number(const JSON::Key &key);
         double get_number(std::string &key);
         double get_number(int index);
         bool get_boolean(const char *key);
+        bool get_boolean(const JSON::Key &key);
         bool get_boolean(std::string &key);
         bool get_boolean(int index);
 
         JSON::Type get_type(const char *key);
+        JSON::Type get_type(const JSON::Key &key);
         JSON::Type get_type(std::string &key);
         JSON::Type get_type(int index);
         bool is_object(const char *key);
+        bool is_object(const JSON::Key &key);
         bool is_object(std::string &key);
         bool is_object(int index);
         bool is_string(const char *key);
+        bool is_string(const JSON::Key &key);
         bool is_string(std::string &key);
         bool is_string(int index);
         bool is_number(const char *key);
+        bool is_number(const JSON::Key &key);
         bool is_number(std::string &key);
         bool is_number(int index);
         bool is_boolean(const char *key);
+        bool is_boolean(const JSON::Key &key);
         bool is_boolean(std::string &key);
         bool is_boolean(int index);
         bool is_null(const char *key);
+        bool is_null(const JSON::Key &key);
         bool is_null(std::string &key);
         bool is_numm(int index);
 
+        JSON::Object &set(const char *key, double value);
+        JSON::Object &set(const char *key, int value);
+        JSON::Object &set(const char *key, bool value);
+        JSON::Object &set(const char *key, const char *value);
+        JSON::Object &set(const char *key, const std::string &value);
+        JSON::Object &set(const char *key, std::nullptr_t);
+        JSON::Object &set(const char *key, const JSON::Object &value);
+        JSON::Object &set(const char *key, JSON::Object &&value);
+        JSON::Object &set(std::string &key, double value);
+        JSON::Object &set(std::string &key, int value);
+        JSON::Object &set(std::string &key, bool value);
+        JSON::Object &set(std::string &key, const char *value);
+        JSON::Object &set(std::string &key, const std::string &value);
+        JSON::Object &set(std::string &key, std::nullptr_t);
+        JSON::Object &set(std::string &key, const JSON::Object &value);
+        JSON::Object &set(std::string &key, JSON::Object &&value);
+        JSON::Object &set(int index, double value);
+        JSON::Object &set(int index, int value);
+        JSON::Object &set(int index, bool value);
+        JSON::Object &set(int index, const char *value);
+        JSON::Object &set(int index, const std::string &value);
+        JSON::Object &set(int index, std::nullptr_t);
+        JSON::Object &set(int index, const JSON::Object &value);
+        JSON::Object &set(int index, JSON::Object &&value);
+        JSON::Object &append(double value);
+        JSON::Object &append(int value);
+        JSON::Object &append(bool value);
+        JSON::Object &append(const char *value);
+        JSON::Object &append(const std::string &value);
+        JSON::Object &append(std::nullptr_t);
+        JSON::Object &append(const JSON::Object &value);
+        JSON::Object &append(JSON::Object &&value);
+        bool erase(const char *key);
+        bool erase(std::string &key);
+        bool erase(int index);
+
         std::string to_string();
         std::string to_string(unsigned int indent);
         std::string to_string(unsigned int indent, unsigned int depth);
+        void write(std::string &out, unsigned int indent = 0);
+        void write(std::ostream &out, unsigned int indent = 0);
+        void write(JSON::Sink sink, void *context, unsigned int indent = 0);
+        size_t estimate_size(unsigned int indent = 0);
+        std::string to_msgpack();
+        void write_msgpack(std::string &out);
+        void write_msgpack(std::ostream &out);
+        void write_msgpack(JSON::Sink sink, void *context);
+        void write_snapshot(const char *path);
+        void write_snapshot(std::string &path);
 
     private:
+        friend class JSON::_Context;
+        friend class JSON::Document;
+        friend class JSON::PushParser;
+        friend class JSON::Path;
+
         bool _is_array;
+        bool _owns_arena;
+        JSON::ParseMode _mode;
         size_t _size;
-        JSON::_Node **_map;
-        JSON::_Node **_ord;
+        size_t _allocated;
+        size_t _capacity;
+        JSON::_Slot *_map;
+        JSON::_Node *_items;
+        JSON::_String *_keys;
+        JSON::_Arena *_arena;
+        JSON::_KeyPool *_pool;
+        const char *_source;
+        const char *_source_end;
+        int _line;
+        JSON::_Mapping *_mapping;
+
+        Object();
+        JSON::_Node *_find(const char *, size_t, size_t);
         JSON::_Node *_get(const char *, Type);
+        JSON::_Node *_get(const JSON::Key &, Type);
+        JSON::_Node *_get(const char *, size_t, size_t, Type);
         JSON::_Node *_get_by_index(int, Type);
-        const char *_initialize(const char *);
+        std::string &_materialize(JSON::_String &);
+        const char *_cstring(JSON::_String &);
+        static JSON::Object _from_file(const char *, JSON::ParseMode, JSON::ParseStats *, JSON::_KeyPool *);
+        const char *_parse(const char *, const char *, JSON::ParseMode, JSON::ParseStats *, JSON::_KeyPool *);
+        const char *_initialize(const char *, JSON::_Context *);
+        const char *_initialize_parallel(const char *, const char *, JSON::_Context *, unsigned int);
+        static const char *_value(const char *, JSON::_Node *, JSON::_Context *);
+        void _unpack(const char *, const char *, JSON::ParseMode, JSON::ParseStats *, JSON::_KeyPool *);
+        const char *_unpack(const char *, JSON::_Context *);
+        static const char *_unpack_value(const char *, JSON::_Node *, JSON::_Context *);
+        void _assemble(JSON::_Context *, size_t, size_t);
+        void _clone(const JSON::Object &, JSON::_Arena *);
+        void _assign(const JSON::Object &);
+        void _steal(JSON::Object &);
+        void _share(const JSON::Object &, JSON::_Arena *);
+        void _link(const JSON::Object &);
+        void _own();
+        JSON::Object *_child(JSON::_Node *);
+        void _store(JSON::_String *, const char *, size_t);
+        JSON::_Node _new_string(const char *);
+        JSON::_Node _new_string(const char *, size_t);
+        JSON::_Node _new_object(const JSON::Object &);
+        JSON::_Node _new_object(JSON::Object &&);
+        void _discard(JSON::_Node &);
+        void _grow();
+        JSON::_Node *_insert(const char *);
+        JSON::Object &_set(const char *, JSON::_Node &);
+        JSON::Object &_set(int, JSON::_Node &);
+        JSON::Object &_append(JSON::_Node &);
+        void _remove(size_t);
+        void _build_index();
+        void _index(JSON::_Node *, size_t, size_t);
+        void _load();
+        void _release();
+        size_t _estimate(unsigned int, unsigned int);
+        void _write(JSON::_Writer *, unsigned int);
+        void _pack(JSON::_Writer *);
+        void _tape(JSON::_TapeBuilder *);
+    };
+
+    class Path
+    {
+    public:
+        Path(const char *pointer);
+        Path(std::string &pointer);
+
+        size_t size() const;
+
+        JSON::PathStatus get_object(JSON::Object &document, JSON::Object **value) const;
+        JSON::PathStatus get_string_view(JSON::Object &document, JSON::StringView *value) const;
+        JSON::PathStatus get_number(JSON::Object &document, double *value) const;
+        JSON::PathStatus get_boolean(JSON::Object &document, bool *value) const;
+        JSON::PathStatus get_type(JSON::Object &document, JSON::Type *value) const;
+
+    private:
+        std::vector<JSON::_Step> _steps;
+        std::string _tokens;
+
+        void _parse(const char *);
+        JSON::PathStatus _resolve(JSON::Object **, JSON::_Node **, bool) const;
+        JSON::PathStatus _resolve(JSON::Object &, JSON::Type, JSON::_Node **) const;
+    };
+
+    class View
+    {
+    public:
+        class Iterator
+        {
+        private:
+            const JSON::View *_view;
+            size_t _word;
+            size_t _index;
+            std::string _buffer;
+
+        public:
+            Iterator(const JSON::View *, size_t, size_t);
+            Iterator &operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator &other);
+            bool operator!=(const Iterator &other);
+            std::string &operator*();
+        };
+
+        JSON::View::Iterator begin() const;
+        JSON::View::Iterator end() const;
+
+        size_t size() const;
+        bool is_array() const;
+
+        JSON::View get_object(const char *key) const;
+        JSON::View get_object(const JSON::Key &key) const;
+        JSON::View get_object(std::string &key) const;
+        JSON::View get_object(int index) const;
+        std::string get_string(const char *key) const;
+        std::string get_string(const JSON::Key &key) const;
+        std::string get_string(std::string &key) const;
+        std::string get_string(int index) const;
+        const char *get_cstring(const char *key) const;
+        const char *get_cstring(const JSON::Key &key) const;
+        const char *get_cstring(std::string &key) const;
+        const char *get_cstring(int index) const;
+        JSON::StringView get_string_view(const char *key) const;
+        JSON::StringView get_string_view(const JSON::Key &key) const;
+        JSON::StringView get_string_view(std::string &key) const;
+        JSON::StringView get_string_view(int index) const;
+        double get_number(const char *key) const;
+        double get_number(const JSON::Key &key) const;
+        double get_number(std::string &key) const;
+        double get_number(int index) const;
+        bool get_boolean(const char *key) const;
+        bool get_boolean(const JSON::Key &key) const;
+        bool get_boolean(std::string &key) const;
+        bool get_boolean(int index) const;
+
+        JSON::Type get_type(const char *key) const;
+        JSON::Type get_type(const JSON::Key &key) const;
+        JSON::Type get_type(std::string &key) const;
+        JSON::Type get_type(int index) const;
+        bool is_object(const char *key) const;
+        bool is_object(const JSON::Key &key) const;
+        bool is_object(std::string &key) const;
+        bool is_object(int index) const;
+        bool is_string(const char *key) const;
+        bool is_string(const JSON::Key &key) const;
+        bool is_string(std::string &key) const;
+        bool is_string(int index) const;
+        bool is_number(const char *key) const;
+        bool is_number(const JSON::Key &key) const;
+        bool is_number(std::string &key) const;
+        bool is_number(int index) const;
+        bool is_boolean(const char *key) const;
+        bool is_boolean(const JSON::Key &key) const;
+        bool is_boolean(std::string &key) const;
+        bool is_boolean(int index) const;
+        bool is_null(const char *key) const;
+        bool is_null(const JSON::Key &key) const;
+        bool is_null(std::string &key) const;
+        bool is_null(int index) const;
+
+        std::string to_string() const;
+        std::string to_string(unsigned int indent) const;
+        void write(std::string &out, unsigned int indent = 0) const;
+        void write(std::ostream &out, unsigned int indent = 0) const;
+        void write(JSON::Sink sink, void *context, unsigned int indent = 0) const;
+        size_t estimate_size(unsigned int indent = 0) const;
+
+    private:
+        friend class JSON::Document;
+
+        const JSON::Document *_document;
+        size_t _word;
+        mutable size_t _cursor;
+        mutable size_t _cursor_index;
+
+        View(const JSON::Document *, size_t);
+        size_t _element(size_t) const;
+        size_t _get(const char *, JSON::Type) const;
+        size_t _get(const JSON::Key &, JSON::Type) const;
+        size_t _get(const char *, size_t, JSON::Type) const;
+        size_t _get(const char *, size_t, size_t, JSON::Type) const;
+        size_t _get_by_index(int, JSON::Type) const;
+        const uint64_t *_table() const;
+        const char *_string(size_t, size_t *) const;
+        size_t _estimate(unsigned int, unsigned int) const;
+        void _write(JSON::_Writer *, unsigned int) const;
+    };
+
+    class Document
+    {
+    public:
+        Document(const char *s);
+        Document(std::string &s);
+        Document(const char *data, size_t length);
+        Document(JSON::Object &object);
+        Document(const Document &);
+        Document(Document &&) noexcept;
+        ~Document();
+
+        static JSON::Document from_snapshot(const char *path);
+        static JSON::Document from_snapshot(std::string &path);
+
+        JSON::View root() const;
+
+        void write_snapshot(const char *path) const;
+        void write_snapshot(std::string &path) const;
+
+    private:
+        friend class JSON::View;
+
+        uint64_t *_tape;
+        size_t _tape_size;
+        char *_strings;
+        size_t _strings_size;
+        uint64_t *_index;
+        size_t _index_size;
+        JSON::_Mapping *_mapping;
+
+        Document();
+        void _parse(const char *, const char *);
+        void _adopt(JSON::_TapeBuilder *);
+    };
+
+    class PushParser
+    {
+    public:
+        PushParser(JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+        ~PushParser();
+
+        size_t feed(const char *data, size_t length);
+        size_t feed(std::string &data);
+        bool done();
+        JSON::Object take();
+        void reset();
+
+    private:
+        enum _State
+        {
+            _VALUE,
+            _VALUE_OR_CLOSE,
+            _KEY,
+            _KEY_OR_CLOSE,
+            _COLON,
+            _COMMA_OR_CLOSE,
+            _DONE
+        };
+
+        JSON::ParseMode _mode;
+        JSON::_Context *_context;
+        std::vector<JSON::_Frame> _frames;
+        std::string _pending;
+        bool _escaped;
+        _State _state;
+
+        PushParser(const PushParser &);
+        PushParser &operator=(const PushParser &);
+        void _start();
+        void _clear();
+        void _open(bool);
+        void _close();
+        const char *_scan(char, const char *, const char *);
+        void _token(const char *, const char *);
+    };
+
+    class Handler
+    {
+    public:
+        virtual ~Handler();
+        virtual void start_object();
+        virtual void key(JSON::StringView key);
+        virtual void end_object();
+        virtual void start_array();
+        virtual void end_array();
+        virtual void string(JSON::StringView value);
+        virtual void number(double value);
+        virtual void boolean(bool value);
+        virtual void null();
+    };
+
+    void parse(const char *s, JSON::Handler &handler);
+    void parse(std::string &s, JSON::Handler &handler);
+    void parse(const char *data, size_t length, JSON::Handler &handler);
+    void parse_file(const char *path, JSON::Handler &handler);
+    void parse_file(std::string &path, JSON::Handler &handler);
+
+    void parse_lines(const char *data, size_t length, JSON::RecordSink sink, void *context, unsigned int threads = 0, JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+    void parse_lines(std::string &data, JSON::RecordSink sink, void *context, unsigned int threads = 0, JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+    void parse_lines_file(const char *path, JSON::RecordSink sink, void *context, unsigned int threads = 0, JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+    void parse_lines_file(std::string &path, JSON::RecordSink sink, void *context, unsigned int threads = 0, JSON::ParseMode mode = JSON::PARSE_DEFAULT);
+
+    enum _Kind
+    {
+        _BOOLEAN,
+        _DOUBLE,
+        _FLOAT,
+        _INT,
+        _UNSIGNED_INT,
+        _LONG,
+        _UNSIGNED_LONG,
+        _LONG_LONG,
+        _UNSIGNED_LONG_LONG,
+        _STRING,
+        _STRUCT,
+        _VECTOR
+    };
+
+    struct _Codec
+    {
+        JSON::_Kind _kind;
+        const JSON::_Binding &(*_binding)();
+        const JSON::_Codec *_element;
+        void (*_clear)(void *);
+        void *(*_append)(void *);
+    };
+
+    struct _Field
+    {
+        JSON::Key _key;
+        const JSON::_Codec *_codec;
+        void *(*_member)(void *);
     };
 
+    class _Binding
+    {
+    public:
+        _Binding(const JSON::_Field *fields, size_t size);
+
+        const JSON::_Field *_find(const char *key, size_t length, size_t *next) const;
+
+    private:
+        const JSON::_Field *_fields;
+        size_t _size;
+        size_t _mask;
+        std::vector<size_t> _table;
+    };
+
+    template <class T>
+    struct _CodecOf
+    {
+        static const JSON::_Codec codec;
+    };
+
+    template <class T>
+    const JSON::_Binding &_binding_of()
+    {
+        return json_binding((T *)NULL);
+    }
+
+    template <class T>
+    const JSON::_Codec _CodecOf<T>::codec = {JSON::_STRUCT, &JSON::_binding_of<T>, NULL, NULL, NULL};
+
+    template <class E>
+    void _clear_vector(void *vector)
+    {
+        ((std::vector<E> *)vector)->clear();
+    }
+
+    template <class E>
+    void *_append_vector(void *vector)
+    {
+        std::vector<E> *v = (std::vector<E> *)vector;
+        v->push_back(E());
+        return &v->back();
+    }
+
+    template <class E>
+    struct _CodecOf<std::vector<E> >
+    {
+        static const JSON::_Codec codec;
+    };
+
+    template <class E>
+    const JSON::_Codec _CodecOf<std::vector<E> >::codec = {JSON::_VECTOR, NULL, &JSON::_CodecOf<E>::codec, &JSON::_clear_vector<E>, &JSON::_append_vector<E>};
+
+    template <> const JSON::_Codec _CodecOf<bool>::codec;
+    template <> const JSON::_Codec _CodecOf<double>::codec;
+    template <> const JSON::_Codec _CodecOf<float>::codec;
+    template <> const JSON::_Codec _CodecOf<int>::codec;
+    template <> const JSON::_Codec _CodecOf<unsigned int>::codec;
+    template <> const JSON::_Codec _CodecOf<long>::codec;
+    template <> const JSON::_Codec _CodecOf<unsigned long>::codec;
+    template <> const JSON::_Codec _CodecOf<long long>::codec;
+    template <> const JSON::_Codec _CodecOf<unsigned long long>::codec;
+    template <> const JSON::_Codec _CodecOf<std::string>::codec;
+
+    template <class T, class M, M T::*P>
+    void *_member(void *object)
+    {
+        return &(((T *)object)->*P);
+    }
+
+    template <class T, class M, M T::*P>
+    constexpr JSON::_Field _field(const JSON::Key &key)
+    {
+        return JSON::_Field{key, &JSON::_CodecOf<M>::codec, &JSON::_member<T, M, P>};
+    }
+
+    void _decode(const char *s, const JSON::_Codec *codec, void *value);
+    void _decode(const char *data, size_t length, const JSON::_Codec *codec, void *value);
+    void _decode_file(const char *path, const JSON::_Codec *codec, void *value);
+
+    template <class T>
+    void decode(const char *s, T *value)
+    {
+        JSON::_decode(s, &JSON::_CodecOf<T>::codec, value);
+    }
+
+    template <class T>
+    void decode(std::string &s, T *value)
+    {
+        JSON::_decode(s.c_str(), &JSON::_CodecOf<T>::codec, value);
+    }
+
+    template <class T>
+    void decode(const char *data, size_t length, T *value)
+    {
+        JSON::_decode(data, length, &JSON::_CodecOf<T>::codec, value);
+    }
+
+    template <class T>
+    void decode_file(const char *path, T *value)
+    {
+        JSON::_decode_file(path, &JSON::_CodecOf<T>::codec, value);
+    }
+
+    template <class T>
+    void decode_file(std::string &path, T *value)
+    {
+        JSON::_decode_file(path.c_str(), &JSON::_CodecOf<T>::codec, value);
+    }
+
     class JSONException : public std::exception
     {
     protected:
@@ -162,6 +852,24 @@ namespace JSON
         InvalidControlCharacterException();
     };
 
+    class FileException : public JSONException
+    {
+    public:
+        FileException(const char *);
+    };
+
+    class InvalidPathException : public JSONException
+    {
+    public:
+        InvalidPathException(const char *);
+    };
+
+    class NotAnArrayException : public JSONException
+    {
+    public:
+        NotAnArrayException();
+    };
+
     class UnknownInternalException : public JSONException
     {
     public:
@@ -169,4 +877,16 @@ namespace JSON
     };
 }
 
+#define JSON_BINDING(type, ...)                                                            \
+    inline const JSON::_Binding &json_binding(type *)                                      \
+    {                                                                                      \
+        typedef type _json_bound;                                                          \
+        static const JSON::_Field fields[] = {__VA_ARGS__};                                \
+        static const JSON::_Binding binding(fields, sizeof(fields) / sizeof(fields[0]));   \
+        return binding;                                                                    \
+    }
+
+#define JSON_FIELD(member) JSON_FIELD_AS(member, #member)
+#define JSON_FIELD_AS(member, name) JSON::_field<_json_bound, decltype(_json_bound::member), &_json_bound::member>(name)
+
 #endif
\ No newline at end of file